@@ -32,6 +32,7 @@
 #include <wupsxx/init.hpp>
 #include <wupsxx/int_item.hpp>
 #include <wupsxx/logger.hpp>
+#include <wupsxx/menu_schema.hpp>
 #include <wupsxx/storage.hpp>
 #include <wupsxx/text_item.hpp>
 
@@ -77,55 +78,78 @@ namespace wpad = wups::utils::wpad;
 
 namespace cfg {
 
-    namespace defaults {
+    // Every setting that has a config item is declared only once, in the schema below.
+    struct settings {
+        bool bool_option_1;
+        bool bool_option_2;
 
-        bool bool_option_1 = true;
-        bool bool_option_2 = false;
+        color foreground;
+        color background;
 
-        color foreground = {0xff, 0x40, 0x80};
-        color background = {0xaa, 0xbb, 0xcc, 0xdd};
+        milliseconds ms_value;
+        seconds      s_value;
+        minutes      min_value;
+        hours        h_value;
 
-        milliseconds ms_value = 10ms;
-        seconds s_value = 10s;
-        minutes min_value = 10min;
-        hours h_value = 10h;
+        int int_value_1;
+        int int_value_2;
 
-        int int_value_1 = 5;
-        int int_value_2 = 0;
+        path some_file;
+        path plugin_file;
 
-        string text = "The quick brown fox jumps over the lazy dog.";
+        button_combo shortcut1;
+        button_combo shortcut2;
+    };
 
-        path some_file = "fs:/vol/external01";
-        path plugin_file = "fs:/vol/external01/wiiu/environments/aroma/plugins";
 
-        button_combo shortcut1 = wpad::button_set{{WPAD_BUTTON_DOWN, WPAD_BUTTON_1},
-                                                  {WPAD_NUNCHUK_BUTTON_C}};
-        button_combo shortcut2 = vpad::button_set{VPAD_BUTTON_B, VPAD_BUTTON_Y};
+    using wups::config::setting;
 
-    } // namespace cfg::defaults
+    const wups::config::menu_schema menu{
+        // A bool item, default=true, strings are true/false
+        setting{"bool_option_1", &settings::bool_option_1, true, "Boolean option 1"},
+        // Another bool item, default=false, strings are ■/□
+        setting{"bool_option_2", &settings::bool_option_2, false, "Boolean option 2",
+                {"■", "□"}},
 
+        // A color item, only RGB
+        setting{"foreground", &settings::foreground, color{0xff, 0x40, 0x80}, "Foreground"},
+        // Another color item, RGBA
+        setting{"background", &settings::background, color{0xaa, 0xbb, 0xcc, 0xdd},
+                "Background", {.has_alpha = true}},
 
-    bool bool_option_1 = defaults::bool_option_1;
-    bool bool_option_2 = defaults::bool_option_2;
+        // Some time duration items
+        setting{"ms_value",  &settings::ms_value,  10ms,  "Duration (ms)",  {0ms, 1000ms}},
+        setting{"s_value",   &settings::s_value,   10s,   "Duration (s)",   {0s, 1000s}},
+        setting{"min_value", &settings::min_value, 10min, "Duration (min)", {0min, 1000min}},
+        setting{"h_value",   &settings::h_value,   10h,   "Duration (h)",   {0h, 1000h}},
 
-    color foreground = defaults::foreground;
-    color background = defaults::background;
+        // An int item
+        setting{"int_value_1", &settings::int_value_1, 5, "Integer option 1", {-100, 100}},
+        // Another int item, with custom increments
+        setting{"int_value_2", &settings::int_value_2, 0, "Integer option 2",
+                {-1000, 1000, 100, 10}},
 
-    milliseconds ms_value  = defaults::ms_value;
-    seconds      s_value   = defaults::s_value;
-    minutes      min_value = defaults::min_value;
-    hours        h_value   = defaults::h_value;
+        // A file item
+        setting{"some_file", &settings::some_file, path{"fs:/vol/external01"}, "Some file"},
+        // A file item for plugin files: only .wps extensions.
+        setting{"plugin_file", &settings::plugin_file,
+                path{"fs:/vol/external01/wiiu/environments/aroma/plugins"}, "Plugin file",
+                {30, {".wps"}}},
 
-    int int_value_1 = defaults::int_value_1;
-    int int_value_2 = defaults::int_value_2;
+        setting{"shortcut1", &settings::shortcut1,
+                button_combo{wpad::button_set{{WPAD_BUTTON_DOWN, WPAD_BUTTON_1},
+                                              {WPAD_NUNCHUK_BUTTON_C}}},
+                "Shortcut1"},
+        setting{"shortcut2", &settings::shortcut2,
+                button_combo{vpad::button_set{VPAD_BUTTON_B, VPAD_BUTTON_Y}},
+                "Shortcut2"},
+    };
 
-    string text = defaults::text;
 
-    path some_file   = defaults::some_file;
-    path plugin_file = defaults::plugin_file;
+    settings current;
 
-    button_combo shortcut1 = defaults::shortcut1;
-    button_combo shortcut2 = defaults::shortcut2;
+    const string default_text = "The quick brown fox jumps over the lazy dog.";
+    string text = default_text;
 
 
     namespace foo {
@@ -141,29 +165,25 @@ namespace cfg {
     }
 
 
+    void
+    log_errors(const wups::storage::schema_result& result)
+    {
+        if (result)
+            return;
+        for (auto& e : result.error())
+            logger::printf("error on \"%.*s\": %s\n",
+                           int(e.key.size()), e.key.data(),
+                           e.error.what());
+    }
+
 
     void
     save()
     {
         try {
-#define STORE(x)  wups::storage::store(#x, x)
-            STORE(bool_option_1);
-            STORE(bool_option_2);
-            STORE(foreground);
-            STORE(background);
-            STORE(ms_value);
-            STORE(s_value);
-            STORE(min_value);
-            STORE(h_value);
-            STORE(int_value_1);
-            STORE(int_value_2);
-            STORE(text);
-            STORE(some_file);
-            STORE(plugin_file);
-            STORE(shortcut1);
-            STORE(shortcut2);
+            log_errors(menu.store(current));
+            wups::storage::store("text", text);
             // TODO: handle nested elements
-#undef STORE
             wups::storage::save();
         }
         catch (std::exception& e) {
@@ -175,23 +195,8 @@ namespace cfg {
     void
     load()
     {
-#define LOAD(x) wups::storage::load_or_init(#x, x, defaults::x)
-        LOAD(bool_option_1);
-        LOAD(bool_option_2);
-        LOAD(foreground);
-        LOAD(background);
-        LOAD(ms_value);
-        LOAD(s_value);
-        LOAD(min_value);
-        LOAD(h_value);
-        LOAD(int_value_1);
-        LOAD(int_value_2);
-        LOAD(text);
-        LOAD(some_file);
-        LOAD(plugin_file);
-        LOAD(shortcut1);
-        LOAD(shortcut2);
-#undef LOAD
+        log_errors(menu.load(current));
+        wups::storage::load_or_init("text", text, default_text);
     }
 
 }
@@ -302,63 +307,8 @@ menu_open(wups::config::category& root)
 {
     using namespace wups::config;
 
-    // A bool item, default=true, strings are true/false
-    root.add(bool_item::create("Boolean option 1",
-                               cfg::bool_option_1,
-                               cfg::defaults::bool_option_1));
-
-    // Another bool item, default=false, strings are ■/□
-    root.add(bool_item::create("Boolean option 2",
-                               cfg::bool_option_2,
-                               cfg::defaults::bool_option_2,
-                               "■", "□"));
-
-
-    // A color item, only RGB
-    root.add(color_item::create("Foreground",
-                                cfg::foreground,
-                                cfg::defaults::foreground));
-
-    // Another color item, RGBA
-    root.add(color_item::create("Background",
-                                cfg::background,
-                                cfg::defaults::background,
-                                true));
-
-
-    // Some time duration items
-    root.add(milliseconds_item::create("Duration (ms)",
-                                       cfg::ms_value,
-                                       cfg::defaults::ms_value,
-                                       0ms, 1000ms));
-
-    root.add(seconds_item::create("Duration (s)",
-                                  cfg::s_value,
-                                  cfg::defaults::s_value,
-                                  0s, 1000s));
-
-    root.add(minutes_item::create("Duration (min)",
-                                  cfg::min_value,
-                                  cfg::defaults::min_value,
-                                  0min, 1000min));
-
-    root.add(hours_item::create("Duration (h)",
-                                cfg::h_value,
-                                cfg::defaults::h_value,
-                                0h, 1000h));
-
-    // An int item
-    root.add(int_item::create("Integer option 1",
-                              cfg::int_value_1,
-                              cfg::defaults::int_value_1,
-                              -100, 100));
-
-    // Another int item, with custom increments
-    root.add(int_item::create("Integer option 2",
-                              cfg::int_value_2,
-                              cfg::defaults::int_value_2,
-                              -1000, 1000,
-                              100, 10));
+    // All the items from the schema.
+    cfg::menu.build(root, cfg::current);
 
 
     // A text item, max width limited to 30 chars.
@@ -371,28 +321,6 @@ menu_open(wups::config::category& root)
                                "FooBar"));
 
 
-    // A file item
-    root.add(file_item::create("Some file",
-                               cfg::some_file,
-                               cfg::defaults::some_file));
-
-    // A file item for plugin files: only .wps extensions.
-    root.add(file_item::create("Plugin file",
-                               cfg::plugin_file,
-                               cfg::defaults::plugin_file,
-                               30,
-                               {".wps"}));
-
-
-    root.add(button_combo_item::create("Shortcut1",
-                                       cfg::shortcut1,
-                                       cfg::defaults::shortcut1));
-
-    root.add(button_combo_item::create("Shortcut2",
-                                       cfg::shortcut2,
-                                       cfg::defaults::shortcut2));
-
-
     root.add(press_counter_item::create());
 
     root.add(wait_5_seconds_item::create());
@@ -508,9 +436,9 @@ DECL_FUNCTION(int32_t,
     const int32_t num_samples = VPADGetButtonProcMode(channel) ? result : 1;
     for (int32_t idx = num_samples - 1; idx >= 0; --idx) {
         if (wups::utils::vpad::update(channel, status[idx])) {
-            if (wups::utils::vpad::triggered(channel, cfg::shortcut1))
+            if (wups::utils::vpad::triggered(channel, cfg::current.shortcut1))
                 activate_shortcut1();
-            if (wups::utils::vpad::triggered(channel, cfg::shortcut2))
+            if (wups::utils::vpad::triggered(channel, cfg::current.shortcut2))
                 activate_shortcut2();
         }
     }
@@ -528,9 +456,9 @@ DECL_FUNCTION(void,
 {
     real_WPADRead(channel, status);
     if (wups::utils::wpad::update(channel, status)) {
-        if (wups::utils::wpad::triggered(channel, cfg::shortcut1))
+        if (wups::utils::wpad::triggered(channel, cfg::current.shortcut1))
             activate_shortcut1();
-        if (wups::utils::wpad::triggered(channel, cfg::shortcut2))
+        if (wups::utils::wpad::triggered(channel, cfg::current.shortcut2))
             activate_shortcut2();
     }
 }
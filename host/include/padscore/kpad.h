@@ -0,0 +1,55 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <padscore/kpad.h>: only what libwupsxx uses, with wut's values.
+
+#ifndef WUPSXX_HOST_PADSCORE_KPAD_H
+#define WUPSXX_HOST_PADSCORE_KPAD_H
+
+#include <stdint.h>
+
+#include <padscore/wpad.h>
+
+typedef enum KPADError {
+    KPAD_ERROR_OK               =  0,
+    KPAD_ERROR_NO_SAMPLES       = -1,
+    KPAD_ERROR_INVALID_CONTROLLER = -2,
+} KPADError;
+
+typedef struct KPADNunchukStatus {
+    uint32_t hold;
+    uint32_t trigger;
+    uint32_t release;
+} KPADNunchukStatus;
+
+typedef struct KPADClassicStatus {
+    uint32_t hold;
+    uint32_t trigger;
+    uint32_t release;
+} KPADClassicStatus;
+
+typedef struct KPADProStatus {
+    uint32_t hold;
+    uint32_t trigger;
+    uint32_t release;
+} KPADProStatus;
+
+typedef struct KPADStatus {
+    uint32_t hold;
+    uint32_t trigger;
+    uint32_t release;
+    uint8_t extensionType;
+    int8_t error;
+    union {
+        KPADNunchukStatus nunchuk;
+        KPADClassicStatus classic;
+        KPADProStatus pro;
+    };
+} KPADStatus;
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <whb/log.h>: logs go to stderr.
+
+#ifndef WUPSXX_HOST_WHB_LOG_H
+#define WUPSXX_HOST_WHB_LOG_H
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BOOL WHBLogWrite(const char* str);
+BOOL WHBLogPrint(const char* str);
+BOOL WHBLogPrintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
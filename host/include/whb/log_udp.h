@@ -0,0 +1,27 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <whb/log_udp.h>.
+
+#ifndef WUPSXX_HOST_WHB_LOG_UDP_H
+#define WUPSXX_HOST_WHB_LOG_UDP_H
+
+#include <wut_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BOOL WHBLogUdpInit(void);
+BOOL WHBLogUdpDeinit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
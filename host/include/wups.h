@@ -0,0 +1,18 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <wups.h>: the config and storage APIs.
+
+#ifndef WUPSXX_HOST_WUPS_H
+#define WUPSXX_HOST_WUPS_H
+
+#include <wups/config.h>
+#include <wups/config_api.h>
+#include <wups/storage.h>
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <wups/config.h>: only what libwupsxx uses, with WUPS's values.
+
+#ifndef WUPSXX_HOST_WUPS_CONFIG_H
+#define WUPSXX_HOST_WUPS_CONFIG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <padscore/kpad.h>
+#include <vpad/input.h>
+
+typedef enum WUPS_CONFIG_SIMPLE_INPUT {
+    WUPS_CONFIG_BUTTON_NONE    = 0,
+    WUPS_CONFIG_BUTTON_LEFT    = (1 << 0),
+    WUPS_CONFIG_BUTTON_RIGHT   = (1 << 1),
+    WUPS_CONFIG_BUTTON_UP      = (1 << 2),
+    WUPS_CONFIG_BUTTON_DOWN    = (1 << 3),
+    WUPS_CONFIG_BUTTON_A       = (1 << 4),
+    WUPS_CONFIG_BUTTON_B       = (1 << 5),
+    WUPS_CONFIG_BUTTON_ZL      = (1 << 6),
+    WUPS_CONFIG_BUTTON_ZR      = (1 << 7),
+    WUPS_CONFIG_BUTTON_L       = (1 << 8),
+    WUPS_CONFIG_BUTTON_R       = (1 << 9),
+    WUPS_CONFIG_BUTTON_PLUS    = (1 << 10),
+    WUPS_CONFIG_BUTTON_MINUS   = (1 << 11),
+    WUPS_CONFIG_BUTTON_X       = (1 << 12),
+    WUPS_CONFIG_BUTTON_Y       = (1 << 13),
+    WUPS_CONFIG_BUTTON_STICK_L = (1 << 14),
+    WUPS_CONFIG_BUTTON_STICK_R = (1 << 15),
+} WUPS_CONFIG_SIMPLE_INPUT;
+
+typedef struct WUPSConfigSimplePadData {
+    WUPS_CONFIG_SIMPLE_INPUT buttons_h;
+    WUPS_CONFIG_SIMPLE_INPUT buttons_d;
+    WUPS_CONFIG_SIMPLE_INPUT buttons_r;
+    bool validPointer;
+    bool touched;
+    float x;
+    float y;
+} WUPSConfigSimplePadData;
+
+typedef struct WUPSConfigComplexPadData {
+    struct {
+        VPADStatus data;
+        VPADReadError vpadError;
+    } vpad;
+    struct {
+        KPADStatus data[7];
+        KPADError kpadError[7];
+    } kpad;
+} WUPSConfigComplexPadData;
+
+typedef enum WUPSConfigAPIStatus {
+    WUPSCONFIG_API_RESULT_SUCCESS                  = 0,
+    WUPSCONFIG_API_RESULT_INVALID_ARGUMENT         = -0x01,
+    WUPSCONFIG_API_RESULT_OUT_OF_MEMORY            = -0x03,
+    WUPSCONFIG_API_RESULT_NOT_FOUND                = -0x06,
+    WUPSCONFIG_API_RESULT_INVALID_PLUGIN_IDENTIFIER = -0x70,
+    WUPSCONFIG_API_RESULT_MISSING_CALLBACK         = -0x71,
+    WUPSCONFIG_API_RESULT_MODULE_NOT_FOUND         = -0x80,
+    WUPSCONFIG_API_RESULT_MODULE_MISSING_EXPORT    = -0x81,
+    WUPSCONFIG_API_RESULT_UNSUPPORTED_VERSION      = -0x82,
+    WUPSCONFIG_API_RESULT_UNSUPPORTED_COMMAND      = -0x83,
+    WUPSCONFIG_API_RESULT_LIB_UNINITIALIZED        = -0x84,
+    WUPSCONFIG_API_RESULT_UNKNOWN_ERROR            = -0x100,
+} WUPSConfigAPIStatus;
+
+typedef enum WUPSConfigAPICallbackStatus {
+    WUPSCONFIG_API_CALLBACK_RESULT_SUCCESS = 0,
+    WUPSCONFIG_API_CALLBACK_RESULT_ERROR   = -1,
+} WUPSConfigAPICallbackStatus;
+
+typedef struct WUPSConfigItemHandle {
+    void* handle;
+} WUPSConfigItemHandle;
+
+typedef struct WUPSConfigCategoryHandle {
+    void* handle;
+} WUPSConfigCategoryHandle;
+
+#endif
@@ -0,0 +1,16 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <wups/config/WUPSConfigItem.h>.
+
+#ifndef WUPSXX_HOST_WUPS_CONFIG_WUPSCONFIGITEM_H
+#define WUPSXX_HOST_WUPS_CONFIG_WUPSCONFIGITEM_H
+
+#include <wups/config.h>
+
+#endif
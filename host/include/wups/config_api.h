@@ -0,0 +1,80 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <wups/config_api.h>, backed by an in-memory menu (see
+// src/config_api.cpp.) It mirrors the subset of the WUPS config API that libwupsxx uses.
+
+#ifndef WUPSXX_HOST_WUPS_CONFIG_API_H
+#define WUPSXX_HOST_WUPS_CONFIG_API_H
+
+#include <stdint.h>
+
+#include <wups/config.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct WUPSConfigAPIItemCallbacksV2 {
+    int32_t (*getCurrentValueDisplay)(void* context, char* buf, int32_t size);
+    int32_t (*getCurrentValueSelectedDisplay)(void* context, char* buf, int32_t size);
+    void (*onSelected)(void* context, bool isSelected);
+    void (*restoreDefault)(void* context);
+    bool (*isMovementAllowed)(void* context);
+    void (*onCloseCallback)(void* context);
+    void (*onInput)(void* context, WUPSConfigSimplePadData input);
+    void (*onInputEx)(void* context, WUPSConfigComplexPadData input);
+    void (*onDelete)(void* context);
+} WUPSConfigAPIItemCallbacksV2;
+
+typedef struct WUPSConfigAPIItemOptionsV2 {
+    const char* displayName;
+    void* context;
+    WUPSConfigAPIItemCallbacksV2 callbacks;
+} WUPSConfigAPIItemOptionsV2;
+
+typedef struct WUPSConfigAPICreateCategoryOptionsV1 {
+    const char* name;
+} WUPSConfigAPICreateCategoryOptionsV1;
+
+typedef struct WUPSConfigAPIOptionsV1 {
+    const char* name;
+} WUPSConfigAPIOptionsV1;
+
+typedef WUPSConfigAPICallbackStatus (*WUPSConfigAPI_MenuOpenedCallback)(WUPSConfigCategoryHandle root);
+
+typedef void (*WUPSConfigAPI_MenuClosedCallback)(void);
+
+
+WUPSConfigAPIStatus WUPSConfigAPI_Init(WUPSConfigAPIOptionsV1 options,
+                                       WUPSConfigAPI_MenuOpenedCallback openedCallback,
+                                       WUPSConfigAPI_MenuClosedCallback closedCallback);
+
+WUPSConfigAPIStatus WUPSConfigAPI_Category_Create(WUPSConfigAPICreateCategoryOptionsV1 options,
+                                                  WUPSConfigCategoryHandle* out);
+
+WUPSConfigAPIStatus WUPSConfigAPI_Category_Destroy(WUPSConfigCategoryHandle handle);
+
+WUPSConfigAPIStatus WUPSConfigAPI_Category_AddCategory(WUPSConfigCategoryHandle parent,
+                                                       WUPSConfigCategoryHandle child);
+
+WUPSConfigAPIStatus WUPSConfigAPI_Category_AddItem(WUPSConfigCategoryHandle parent,
+                                                   WUPSConfigItemHandle item);
+
+WUPSConfigAPIStatus WUPSConfigAPI_Item_Create(WUPSConfigAPIItemOptionsV2 options,
+                                              WUPSConfigItemHandle* out);
+
+WUPSConfigAPIStatus WUPSConfigAPI_Item_Destroy(WUPSConfigItemHandle handle);
+
+const char* WUPSConfigAPI_GetStatusStr(WUPSConfigAPIStatus status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <wups/storage.h>, backed by an in-memory store (see src/storage.cpp.)
+// It mirrors the subset of the WUPS storage API that libwupsxx uses.
+
+#ifndef WUPSXX_HOST_WUPS_STORAGE_H
+#define WUPSXX_HOST_WUPS_STORAGE_H
+
+#include <stdint.h>
+
+typedef enum WUPSStorageError {
+    WUPS_STORAGE_ERROR_SUCCESS                  = 0,
+    WUPS_STORAGE_ERROR_INVALID_ARGUMENT         = -0x01,
+    WUPS_STORAGE_ERROR_MALLOC_FAILED            = -0x02,
+    WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE     = -0x03,
+    WUPS_STORAGE_ERROR_BUFFER_TOO_SMALL         = -0x04,
+    WUPS_STORAGE_ERROR_ALREADY_EXISTS           = -0x05,
+    WUPS_STORAGE_ERROR_IO_ERROR                 = -0x06,
+    WUPS_STORAGE_ERROR_NOT_FOUND                = -0x10,
+    WUPS_STORAGE_ERROR_INTERNAL_NOT_INITIALIZED = -0xF0,
+    WUPS_STORAGE_ERROR_INTERNAL_INVALID_VERSION = -0xF1,
+    WUPS_STORAGE_ERROR_UNKNOWN_ERROR            = -0x100,
+} WUPSStorageError;
+
+typedef enum WUPSStorageItemTypes {
+    WUPS_STORAGE_ITEM_S32    = 0,
+    WUPS_STORAGE_ITEM_S64    = 1,
+    WUPS_STORAGE_ITEM_U32    = 2,
+    WUPS_STORAGE_ITEM_U64    = 3,
+    WUPS_STORAGE_ITEM_STRING = 4,
+    WUPS_STORAGE_ITEM_BINARY = 5,
+    WUPS_STORAGE_ITEM_BOOL   = 6,
+    WUPS_STORAGE_ITEM_FLOAT  = 7,
+    WUPS_STORAGE_ITEM_DOUBLE = 8,
+} WUPSStorageItemTypes;
+
+typedef uint32_t WUPSStorageItemType;
+
+typedef void* wups_storage_item;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const char* WUPSStorageAPI_GetStatusStr(WUPSStorageError status);
+
+WUPSStorageError WUPSStorageAPI_SaveStorage(bool forceSave);
+
+WUPSStorageError WUPSStorageAPI_ForceReloadStorage(void);
+
+WUPSStorageError WUPSStorageAPI_WipeStorage(void);
+
+WUPSStorageError WUPSStorageAPI_DeleteItem(wups_storage_item parent,
+                                           const char* key);
+
+WUPSStorageError WUPSStorageAPI_CreateSubItem(wups_storage_item parent,
+                                              const char* key,
+                                              wups_storage_item* outItem);
+
+WUPSStorageError WUPSStorageAPI_GetSubItem(wups_storage_item parent,
+                                           const char* key,
+                                           wups_storage_item* outItem);
+
+WUPSStorageError WUPSStorageAPI_StoreItem(wups_storage_item parent,
+                                          const char* key,
+                                          WUPSStorageItemType type,
+                                          void* data,
+                                          uint32_t size);
+
+WUPSStorageError WUPSStorageAPI_GetItem(wups_storage_item parent,
+                                        const char* key,
+                                        WUPSStorageItemType type,
+                                        void* data,
+                                        uint32_t maxSize,
+                                        uint32_t* outSize);
+
+WUPSStorageError WUPSStorageAPI_GetItemSize(wups_storage_item parent,
+                                            const char* key,
+                                            WUPSStorageItemType itemType,
+                                            uint32_t* outSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#ifdef __cplusplus
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace WUPSStorageAPI {
+
+    enum class GetOptions {
+        NONE,
+        RESIZE_EXISTING_BUFFER,
+    };
+
+
+    inline
+    std::string_view
+    GetStatusStr(const WUPSStorageError& err)
+        noexcept
+    {
+        return WUPSStorageAPI_GetStatusStr(err);
+    }
+
+
+    inline
+    WUPSStorageError
+    SaveStorage(bool forceSave = false)
+        noexcept
+    {
+        return WUPSStorageAPI_SaveStorage(forceSave);
+    }
+
+
+    inline
+    WUPSStorageError
+    ForceReloadStorage()
+        noexcept
+    {
+        return WUPSStorageAPI_ForceReloadStorage();
+    }
+
+
+    inline
+    WUPSStorageError
+    WipeStorage()
+        noexcept
+    {
+        return WUPSStorageAPI_WipeStorage();
+    }
+
+
+    inline
+    WUPSStorageError
+    DeleteItem(std::string_view key)
+        noexcept
+    {
+        return WUPSStorageAPI_DeleteItem(nullptr, key.data());
+    }
+
+
+    inline
+    WUPSStorageError
+    GetItemSize(std::string_view key,
+                WUPSStorageItemType itemType,
+                uint32_t& outSize)
+        noexcept
+    {
+        return WUPSStorageAPI_GetItemSize(nullptr, key.data(), itemType, &outSize);
+    }
+
+
+    namespace detail {
+
+        template<typename T>
+        constexpr WUPSStorageItemType item_type_of() noexcept
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                return WUPS_STORAGE_ITEM_BOOL;
+            else if constexpr (std::is_same_v<T, float>)
+                return WUPS_STORAGE_ITEM_FLOAT;
+            else if constexpr (std::is_same_v<T, double>)
+                return WUPS_STORAGE_ITEM_DOUBLE;
+            else if constexpr (std::is_enum_v<T>) {
+                static_assert(sizeof(T) == sizeof(std::uint32_t),
+                              "enums must have the size of uint32_t");
+                return WUPS_STORAGE_ITEM_U32;
+            } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                static_assert(sizeof(T) == 4 || sizeof(T) == 8,
+                              "only 32 and 64 bit integers are supported");
+                return sizeof(T) == 4 ? WUPS_STORAGE_ITEM_S32 : WUPS_STORAGE_ITEM_S64;
+            } else if constexpr (std::is_integral_v<T>) {
+                static_assert(sizeof(T) == 4 || sizeof(T) == 8,
+                              "only 32 and 64 bit integers are supported");
+                return sizeof(T) == 4 ? WUPS_STORAGE_ITEM_U32 : WUPS_STORAGE_ITEM_U64;
+            } else
+                static_assert(sizeof(T) == 0, "unsupported storage type");
+        }
+
+    } // namespace detail
+
+
+    template<typename T>
+    WUPSStorageError
+    GetEx(wups_storage_item parent,
+          std::string_view key,
+          T& outValue,
+          GetOptions options = GetOptions::RESIZE_EXISTING_BUFFER)
+        noexcept
+    {
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (options == GetOptions::RESIZE_EXISTING_BUFFER) {
+                uint32_t size = 0;
+                auto status = WUPSStorageAPI_GetItemSize(parent, key.data(),
+                                                         WUPS_STORAGE_ITEM_STRING, &size);
+                if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                    return status;
+                outValue.resize(size);
+            }
+            uint32_t outSize = 0;
+            auto status = WUPSStorageAPI_GetItem(parent, key.data(),
+                                                 WUPS_STORAGE_ITEM_STRING,
+                                                 outValue.data(), outValue.size(),
+                                                 &outSize);
+            if (status == WUPS_STORAGE_ERROR_SUCCESS)
+                outValue.resize(std::strlen(outValue.c_str()));
+            return status;
+        } else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>) {
+            if (options == GetOptions::RESIZE_EXISTING_BUFFER) {
+                uint32_t size = 0;
+                auto status = WUPSStorageAPI_GetItemSize(parent, key.data(),
+                                                         WUPS_STORAGE_ITEM_BINARY, &size);
+                if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                    return status;
+                outValue.resize(size);
+            }
+            uint32_t outSize = 0;
+            auto status = WUPSStorageAPI_GetItem(parent, key.data(),
+                                                 WUPS_STORAGE_ITEM_BINARY,
+                                                 outValue.data(), outValue.size(),
+                                                 &outSize);
+            if (status == WUPS_STORAGE_ERROR_SUCCESS)
+                outValue.resize(outSize);
+            return status;
+        } else {
+            return WUPSStorageAPI_GetItem(parent, key.data(),
+                                          detail::item_type_of<T>(),
+                                          &outValue, sizeof outValue,
+                                          nullptr);
+        }
+    }
+
+
+    template<typename T>
+    WUPSStorageError
+    StoreEx(wups_storage_item parent,
+            std::string_view key,
+            const T& value)
+        noexcept
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+            return WUPSStorageAPI_StoreItem(parent, key.data(),
+                                            WUPS_STORAGE_ITEM_STRING,
+                                            const_cast<char*>(value.c_str()),
+                                            value.size());
+        else if constexpr (std::is_same_v<T, std::vector<std::uint8_t>>)
+            return WUPSStorageAPI_StoreItem(parent, key.data(),
+                                            WUPS_STORAGE_ITEM_BINARY,
+                                            const_cast<std::uint8_t*>(value.data()),
+                                            value.size());
+        else
+            return WUPSStorageAPI_StoreItem(parent, key.data(),
+                                            detail::item_type_of<T>(),
+                                            const_cast<T*>(&value),
+                                            sizeof value);
+    }
+
+
+    template<typename T>
+    WUPSStorageError
+    Get(std::string_view key,
+        T& outValue,
+        GetOptions options = GetOptions::RESIZE_EXISTING_BUFFER)
+        noexcept
+    {
+        return GetEx(nullptr, key, outValue, options);
+    }
+
+
+    template<typename T>
+    WUPSStorageError
+    Store(std::string_view key,
+          const T& value)
+        noexcept
+    {
+        return StoreEx(nullptr, key, value);
+    }
+
+} // namespace WUPSStorageAPI
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_HOST_CONFIG_HPP
+#define WUPSXX_HOST_CONFIG_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/*
+ * Controls for the in-memory config menu used in host builds.
+ *
+ * It plays the role of the WUPS config menu: open_menu() calls the callback registered by
+ * WUPSConfigAPI_Init() (that is, by wups::config::init()), and draw() renders the rows of
+ * the current category the way the menu does, categories first. Unlike WUPS, entering a
+ * category doesn't take a snapshot of its items.
+ */
+
+namespace wups::host::config {
+
+    // Size of the buffer the items render their value into.
+    inline constexpr std::size_t display_size = 256;
+
+
+    // Create the root category and call the open callback; false if it failed.
+    bool open_menu();
+
+
+    // Destroy the whole menu, deleting the items, and call the close callback.
+    void close_menu();
+
+
+    // Render the first `rows` rows of the current category: the category names, then
+    // "label: value" for each item.
+    std::vector<std::string> draw(std::size_t rows);
+
+
+    // Enter the child category at `index`; false if there's no such category.
+    bool enter(std::size_t index);
+
+
+    // Go back to the parent category.
+    void leave() noexcept;
+
+
+    // Number of items created through WUPSConfigAPI_Item_Create() and not destroyed yet.
+    std::size_t live_items() noexcept;
+
+} // namespace wups::host::config
+
+#endif
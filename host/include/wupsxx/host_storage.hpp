@@ -0,0 +1,54 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_HOST_STORAGE_HPP
+#define WUPSXX_HOST_STORAGE_HPP
+
+#include <cstddef>
+
+#include <wups/storage.h>
+
+
+/*
+ * Controls for the in-memory storage backend used in host builds.
+ *
+ * The backend keeps two trees: the live one, that all the WUPSStorageAPI calls operate
+ * on, and the saved one, that plays the role of the config file. SaveStorage() copies the
+ * live tree into the saved one, and ForceReloadStorage() does the opposite.
+ */
+
+namespace wups::host::storage {
+
+    // Empty both the live and saved trees, and clear the counters and injected errors.
+    void reset() noexcept;
+
+
+    // Number of successful SaveStorage() calls since the last reset().
+    std::size_t save_count() noexcept;
+
+
+    // Number of successful ForceReloadStorage() calls since the last reset().
+    std::size_t reload_count() noexcept;
+
+
+    // Make the next SaveStorage() fail with this status, without touching the saved tree.
+    void fail_next_save(WUPSStorageError status) noexcept;
+
+
+    // Make a StoreItem() fail with this status, without touching the live tree; the
+    // first `skip` calls still succeed.
+    void fail_next_store(WUPSStorageError status, std::size_t skip = 0) noexcept;
+
+
+    // Make the next ForceReloadStorage() fail with this status, like a corrupted config
+    // file: the live tree is left empty.
+    void fail_next_reload(WUPSStorageError status) noexcept;
+
+} // namespace wups::host::storage
+
+#endif
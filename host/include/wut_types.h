@@ -0,0 +1,26 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host stand-in for <wut_types.h>.
+
+#ifndef WUPSXX_HOST_WUT_TYPES_H
+#define WUPSXX_HOST_WUT_TYPES_H
+
+#include <stdint.h>
+
+typedef int32_t BOOL;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#endif
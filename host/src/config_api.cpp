@@ -0,0 +1,279 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * In-memory implementation of the WUPS config API, for host builds.
+ *
+ * A handle is a pointer to a node. Categories own the categories and items added to them;
+ * destroying a category destroys its contents, calling onDelete() on every item.
+ */
+
+#include <algorithm>            // erase(), find()
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <wups/config_api.h>
+
+#include "wupsxx/host_config.hpp"
+
+
+namespace {
+
+    struct category_node;
+
+
+    struct item_node {
+        std::string name;
+        void* context;
+        WUPSConfigAPIItemCallbacksV2 callbacks;
+        category_node* parent = nullptr;
+    };
+
+
+    struct category_node {
+        std::string name;
+        std::vector<category_node*> categories = {};
+        std::vector<item_node*> items = {};
+        category_node* parent = nullptr;
+    };
+
+
+    WUPSConfigAPI_MenuOpenedCallback open_callback = nullptr;
+    WUPSConfigAPI_MenuClosedCallback close_callback = nullptr;
+
+    category_node* root = nullptr;
+    category_node* current = nullptr;
+    std::size_t items = 0;
+
+
+    void
+    destroy(item_node* it)
+    {
+        if (it->parent)
+            std::erase(it->parent->items, it);
+        --items;
+        auto callbacks = it->callbacks;
+        auto context = it->context;
+        delete it;
+        if (callbacks.onDelete)
+            callbacks.onDelete(context);
+    }
+
+
+    void
+    destroy(category_node* cat)
+    {
+        while (!cat->items.empty())
+            destroy(cat->items.back());
+        while (!cat->categories.empty())
+            destroy(cat->categories.back());
+        if (cat->parent)
+            std::erase(cat->parent->categories, cat);
+        delete cat;
+    }
+
+} // namespace
+
+
+namespace wups::host::config {
+
+    bool
+    open_menu()
+    {
+        if (root)
+            close_menu();
+        if (!open_callback)
+            return false;
+        root = new category_node{};
+        current = root;
+        if (open_callback({root}) != WUPSCONFIG_API_CALLBACK_RESULT_SUCCESS) {
+            destroy(root);
+            root = current = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+
+    void
+    close_menu()
+    {
+        if (!root)
+            return;
+        destroy(root);
+        root = current = nullptr;
+        if (close_callback)
+            close_callback();
+    }
+
+
+    std::vector<std::string>
+    draw(std::size_t rows)
+    {
+        std::vector<std::string> result;
+        if (!current)
+            return result;
+
+        for (auto cat : current->categories) {
+            if (result.size() == rows)
+                return result;
+            result.push_back(cat->name);
+        }
+
+        for (auto it : current->items) {
+            if (result.size() == rows)
+                break;
+            char buf[display_size] = {};
+            if (it->callbacks.getCurrentValueDisplay)
+                it->callbacks.getCurrentValueDisplay(it->context, buf, sizeof buf);
+            result.push_back(it->name + ": " + buf);
+        }
+        return result;
+    }
+
+
+    bool
+    enter(std::size_t index)
+    {
+        if (!current || index >= current->categories.size())
+            return false;
+        current = current->categories[index];
+        return true;
+    }
+
+
+    void
+    leave()
+        noexcept
+    {
+        if (current && current->parent)
+            current = current->parent;
+    }
+
+
+    std::size_t
+    live_items()
+        noexcept
+    {
+        return items;
+    }
+
+} // namespace wups::host::config
+
+
+extern "C" {
+
+    WUPSConfigAPIStatus
+    WUPSConfigAPI_Init(WUPSConfigAPIOptionsV1 /*options*/,
+                       WUPSConfigAPI_MenuOpenedCallback openedCallback,
+                       WUPSConfigAPI_MenuClosedCallback closedCallback)
+    {
+        if (!openedCallback || !closedCallback)
+            return WUPSCONFIG_API_RESULT_INVALID_ARGUMENT;
+        open_callback = openedCallback;
+        close_callback = closedCallback;
+        return WUPSCONFIG_API_RESULT_SUCCESS;
+    }
+
+
+    WUPSConfigAPIStatus
+    WUPSConfigAPI_Category_Create(WUPSConfigAPICreateCategoryOptionsV1 options,
+                                  WUPSConfigCategoryHandle* out)
+    {
+        if (!options.name || !out)
+            return WUPSCONFIG_API_RESULT_INVALID_ARGUMENT;
+        out->handle = new category_node{ .name = options.name };
+        return WUPSCONFIG_API_RESULT_SUCCESS;
+    }
+
+
+    WUPSConfigAPIStatus
+    WUPSConfigAPI_Category_Destroy(WUPSConfigCategoryHandle handle)
+    {
+        auto cat = static_cast<category_node*>(handle.handle);
+        if (!cat || cat == root)
+            return WUPSCONFIG_API_RESULT_INVALID_ARGUMENT;
+        destroy(cat);
+        return WUPSCONFIG_API_RESULT_SUCCESS;
+    }
+
+
+    WUPSConfigAPIStatus
+    WUPSConfigAPI_Category_AddCategory(WUPSConfigCategoryHandle parent,
+                                       WUPSConfigCategoryHandle child)
+    {
+        auto p = static_cast<category_node*>(parent.handle);
+        auto c = static_cast<category_node*>(child.handle);
+        if (!p || !c || c->parent || c == root)
+            return WUPSCONFIG_API_RESULT_INVALID_ARGUMENT;
+        c->parent = p;
+        p->categories.push_back(c);
+        return WUPSCONFIG_API_RESULT_SUCCESS;
+    }
+
+
+    WUPSConfigAPIStatus
+    WUPSConfigAPI_Category_AddItem(WUPSConfigCategoryHandle parent,
+                                   WUPSConfigItemHandle item)
+    {
+        auto p = static_cast<category_node*>(parent.handle);
+        auto it = static_cast<item_node*>(item.handle);
+        if (!p || !it || it->parent)
+            return WUPSCONFIG_API_RESULT_INVALID_ARGUMENT;
+        it->parent = p;
+        p->items.push_back(it);
+        return WUPSCONFIG_API_RESULT_SUCCESS;
+    }
+
+
+    WUPSConfigAPIStatus
+    WUPSConfigAPI_Item_Create(WUPSConfigAPIItemOptionsV2 options,
+                              WUPSConfigItemHandle* out)
+    {
+        if (!options.displayName || !out)
+            return WUPSCONFIG_API_RESULT_INVALID_ARGUMENT;
+        out->handle = new item_node{
+            .name = options.displayName,
+            .context = options.context,
+            .callbacks = options.callbacks,
+        };
+        ++items;
+        return WUPSCONFIG_API_RESULT_SUCCESS;
+    }
+
+
+    WUPSConfigAPIStatus
+    WUPSConfigAPI_Item_Destroy(WUPSConfigItemHandle handle)
+    {
+        auto it = static_cast<item_node*>(handle.handle);
+        if (!it)
+            return WUPSCONFIG_API_RESULT_INVALID_ARGUMENT;
+        destroy(it);
+        return WUPSCONFIG_API_RESULT_SUCCESS;
+    }
+
+
+    const char*
+    WUPSConfigAPI_GetStatusStr(WUPSConfigAPIStatus status)
+    {
+        switch (status) {
+        case WUPSCONFIG_API_RESULT_SUCCESS:
+            return "WUPSCONFIG_API_RESULT_SUCCESS";
+        case WUPSCONFIG_API_RESULT_INVALID_ARGUMENT:
+            return "WUPSCONFIG_API_RESULT_INVALID_ARGUMENT";
+        case WUPSCONFIG_API_RESULT_OUT_OF_MEMORY:
+            return "WUPSCONFIG_API_RESULT_OUT_OF_MEMORY";
+        case WUPSCONFIG_API_RESULT_NOT_FOUND:
+            return "WUPSCONFIG_API_RESULT_NOT_FOUND";
+        default:
+            return "WUPSCONFIG_API_RESULT_UNKNOWN_ERROR";
+        }
+    }
+
+} // extern "C"
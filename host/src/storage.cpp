@@ -0,0 +1,413 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/*
+ * In-memory implementation of the WUPS storage API, for host builds.
+ *
+ * Items are kept in a tree of sub-items; a wups_storage_item handle is a pointer to a
+ * sub-item, and nullptr is the root. Like on the console, handles are invalidated by
+ * ForceReloadStorage(), WipeStorage(), and by deleting the sub-item.
+ */
+
+#include <cstddef>
+#include <cstring>              // memcpy(), strlen()
+#include <map>
+#include <memory>
+#include <new>                  // bad_alloc
+#include <mutex>
+#include <string>
+#include <utility>              // move()
+#include <variant>
+#include <vector>
+
+#include <wups/storage.h>
+
+#include "wupsxx/host_storage.hpp"
+
+
+namespace {
+
+    struct sub_item;
+
+
+    struct value {
+        WUPSStorageItemType type;
+        std::vector<std::byte> data;
+    };
+
+
+    using node = std::variant<value, std::unique_ptr<sub_item>>;
+
+
+    struct sub_item {
+        std::map<std::string, node, std::less<>> children;
+    };
+
+
+    std::mutex mut;
+    sub_item live;
+    sub_item saved;
+    std::size_t saves = 0;
+    std::size_t reloads = 0;
+    WUPSStorageError next_save_error = WUPS_STORAGE_ERROR_SUCCESS;
+    WUPSStorageError next_store_error = WUPS_STORAGE_ERROR_SUCCESS;
+    std::size_t stores_before_error = 0;
+    WUPSStorageError next_reload_error = WUPS_STORAGE_ERROR_SUCCESS;
+
+
+    void
+    deep_copy(sub_item& dst,
+              const sub_item& src)
+    {
+        dst.children.clear();
+        for (auto& [name, child] : src.children) {
+            if (auto v = std::get_if<value>(&child))
+                dst.children.emplace(name, *v);
+            else {
+                auto copy = std::make_unique<sub_item>();
+                deep_copy(*copy, *std::get<std::unique_ptr<sub_item>>(child));
+                dst.children.emplace(name, std::move(copy));
+            }
+        }
+    }
+
+
+    // Call `func`; returns false if it ran out of memory. Without exceptions, running out
+    // of memory aborts instead.
+    template<typename F>
+    bool
+    try_alloc(F&& func)
+    {
+#ifdef __cpp_exceptions
+        try {
+            func();
+        }
+        catch (std::bad_alloc&) {
+            return false;
+        }
+#else
+        func();
+#endif
+        return true;
+    }
+
+
+    sub_item&
+    resolve(wups_storage_item handle)
+        noexcept
+    {
+        if (!handle)
+            return live;
+        return *static_cast<sub_item*>(handle);
+    }
+
+
+    // Size reported for an item: strings include the null terminator.
+    std::uint32_t
+    reported_size(const value& v)
+        noexcept
+    {
+        if (v.type == WUPS_STORAGE_ITEM_STRING)
+            return v.data.size() + 1;
+        return v.data.size();
+    }
+
+
+    bool
+    is_fixed_size(WUPSStorageItemType type)
+        noexcept
+    {
+        return type != WUPS_STORAGE_ITEM_STRING && type != WUPS_STORAGE_ITEM_BINARY;
+    }
+
+} // namespace
+
+
+namespace wups::host::storage {
+
+    void
+    reset()
+        noexcept
+    {
+        std::lock_guard guard{mut};
+        live.children.clear();
+        saved.children.clear();
+        saves = 0;
+        reloads = 0;
+        next_save_error = WUPS_STORAGE_ERROR_SUCCESS;
+        next_store_error = WUPS_STORAGE_ERROR_SUCCESS;
+        stores_before_error = 0;
+        next_reload_error = WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    std::size_t
+    save_count()
+        noexcept
+    {
+        std::lock_guard guard{mut};
+        return saves;
+    }
+
+
+    std::size_t
+    reload_count()
+        noexcept
+    {
+        std::lock_guard guard{mut};
+        return reloads;
+    }
+
+
+    void
+    fail_next_save(WUPSStorageError status)
+        noexcept
+    {
+        std::lock_guard guard{mut};
+        next_save_error = status;
+    }
+
+
+    void
+    fail_next_store(WUPSStorageError status,
+                    std::size_t skip)
+        noexcept
+    {
+        std::lock_guard guard{mut};
+        next_store_error = status;
+        stores_before_error = skip;
+    }
+
+
+    void
+    fail_next_reload(WUPSStorageError status)
+        noexcept
+    {
+        std::lock_guard guard{mut};
+        next_reload_error = status;
+    }
+
+} // namespace wups::host::storage
+
+
+extern "C" {
+
+    const char*
+    WUPSStorageAPI_GetStatusStr(WUPSStorageError status)
+    {
+        switch (status) {
+        case WUPS_STORAGE_ERROR_SUCCESS:
+            return "WUPS_STORAGE_ERROR_SUCCESS";
+        case WUPS_STORAGE_ERROR_INVALID_ARGUMENT:
+            return "WUPS_STORAGE_ERROR_INVALID_ARGUMENT";
+        case WUPS_STORAGE_ERROR_MALLOC_FAILED:
+            return "WUPS_STORAGE_ERROR_MALLOC_FAILED";
+        case WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE:
+            return "WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE";
+        case WUPS_STORAGE_ERROR_BUFFER_TOO_SMALL:
+            return "WUPS_STORAGE_ERROR_BUFFER_TOO_SMALL";
+        case WUPS_STORAGE_ERROR_ALREADY_EXISTS:
+            return "WUPS_STORAGE_ERROR_ALREADY_EXISTS";
+        case WUPS_STORAGE_ERROR_IO_ERROR:
+            return "WUPS_STORAGE_ERROR_IO_ERROR";
+        case WUPS_STORAGE_ERROR_NOT_FOUND:
+            return "WUPS_STORAGE_ERROR_NOT_FOUND";
+        case WUPS_STORAGE_ERROR_INTERNAL_NOT_INITIALIZED:
+            return "WUPS_STORAGE_ERROR_INTERNAL_NOT_INITIALIZED";
+        case WUPS_STORAGE_ERROR_INTERNAL_INVALID_VERSION:
+            return "WUPS_STORAGE_ERROR_INTERNAL_INVALID_VERSION";
+        case WUPS_STORAGE_ERROR_UNKNOWN_ERROR:
+            return "WUPS_STORAGE_ERROR_UNKNOWN_ERROR";
+        }
+        return "WUPS_STORAGE_ERROR_UNKNOWN";
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_SaveStorage(bool /*forceSave*/)
+    {
+        std::lock_guard guard{mut};
+        if (next_save_error != WUPS_STORAGE_ERROR_SUCCESS)
+            return std::exchange(next_save_error, WUPS_STORAGE_ERROR_SUCCESS);
+        if (!try_alloc([] { deep_copy(saved, live); }))
+            return WUPS_STORAGE_ERROR_MALLOC_FAILED;
+        ++saves;
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_ForceReloadStorage()
+    {
+        std::lock_guard guard{mut};
+        if (next_reload_error != WUPS_STORAGE_ERROR_SUCCESS) {
+            // Like a config file that can't be parsed: nothing is loaded.
+            live.children.clear();
+            return std::exchange(next_reload_error, WUPS_STORAGE_ERROR_SUCCESS);
+        }
+        if (!try_alloc([] { deep_copy(live, saved); }))
+            return WUPS_STORAGE_ERROR_MALLOC_FAILED;
+        ++reloads;
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_WipeStorage()
+    {
+        std::lock_guard guard{mut};
+        live.children.clear();
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_DeleteItem(wups_storage_item parent,
+                              const char* key)
+    {
+        if (!key)
+            return WUPS_STORAGE_ERROR_INVALID_ARGUMENT;
+        std::lock_guard guard{mut};
+        auto& children = resolve(parent).children;
+        auto it = children.find(key);
+        if (it == children.end())
+            return WUPS_STORAGE_ERROR_NOT_FOUND;
+        children.erase(it);
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_CreateSubItem(wups_storage_item parent,
+                                 const char* key,
+                                 wups_storage_item* outItem)
+    {
+        if (!key || !outItem)
+            return WUPS_STORAGE_ERROR_INVALID_ARGUMENT;
+        std::lock_guard guard{mut};
+        auto& children = resolve(parent).children;
+        if (children.contains(key))
+            return WUPS_STORAGE_ERROR_ALREADY_EXISTS;
+        bool ok = try_alloc([&]
+        {
+            auto sub = std::make_unique<sub_item>();
+            *outItem = sub.get();
+            children.emplace(key, std::move(sub));
+        });
+        if (!ok)
+            return WUPS_STORAGE_ERROR_MALLOC_FAILED;
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_GetSubItem(wups_storage_item parent,
+                              const char* key,
+                              wups_storage_item* outItem)
+    {
+        if (!key || !outItem)
+            return WUPS_STORAGE_ERROR_INVALID_ARGUMENT;
+        std::lock_guard guard{mut};
+        auto& children = resolve(parent).children;
+        auto it = children.find(key);
+        if (it == children.end())
+            return WUPS_STORAGE_ERROR_NOT_FOUND;
+        auto sub = std::get_if<std::unique_ptr<sub_item>>(&it->second);
+        if (!sub)
+            return WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE;
+        *outItem = sub->get();
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_StoreItem(wups_storage_item parent,
+                             const char* key,
+                             WUPSStorageItemType type,
+                             void* data,
+                             uint32_t size)
+    {
+        if (!key || (!data && size) || type > WUPS_STORAGE_ITEM_DOUBLE)
+            return WUPS_STORAGE_ERROR_INVALID_ARGUMENT;
+        std::lock_guard guard{mut};
+        if (next_store_error != WUPS_STORAGE_ERROR_SUCCESS && !stores_before_error--)
+            return std::exchange(next_store_error, WUPS_STORAGE_ERROR_SUCCESS);
+        auto& children = resolve(parent).children;
+        auto it = children.find(key);
+        // Don't silently replace a sub-item, it would invalidate its handle.
+        if (it != children.end() && !std::holds_alternative<value>(it->second))
+            return WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE;
+        bool ok = try_alloc([&]
+        {
+            auto bytes = static_cast<const std::byte*>(data);
+            value v{type, {bytes, bytes + size}};
+            if (it != children.end())
+                it->second = std::move(v);
+            else
+                children.emplace(key, std::move(v));
+        });
+        if (!ok)
+            return WUPS_STORAGE_ERROR_MALLOC_FAILED;
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_GetItem(wups_storage_item parent,
+                           const char* key,
+                           WUPSStorageItemType type,
+                           void* data,
+                           uint32_t maxSize,
+                           uint32_t* outSize)
+    {
+        if (!key || (!data && maxSize))
+            return WUPS_STORAGE_ERROR_INVALID_ARGUMENT;
+        std::lock_guard guard{mut};
+        auto& children = resolve(parent).children;
+        auto it = children.find(key);
+        if (it == children.end())
+            return WUPS_STORAGE_ERROR_NOT_FOUND;
+        auto v = std::get_if<value>(&it->second);
+        if (!v || v->type != type)
+            return WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE;
+        std::uint32_t size = reported_size(*v);
+        if (is_fixed_size(type) ? size != maxSize : size > maxSize)
+            return WUPS_STORAGE_ERROR_BUFFER_TOO_SMALL;
+        if (!v->data.empty())
+            std::memcpy(data, v->data.data(), v->data.size());
+        if (type == WUPS_STORAGE_ITEM_STRING)
+            static_cast<char*>(data)[v->data.size()] = '\0';
+        if (outSize)
+            *outSize = size;
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+
+    WUPSStorageError
+    WUPSStorageAPI_GetItemSize(wups_storage_item parent,
+                               const char* key,
+                               WUPSStorageItemType itemType,
+                               uint32_t* outSize)
+    {
+        if (!key || !outSize)
+            return WUPS_STORAGE_ERROR_INVALID_ARGUMENT;
+        if (itemType != WUPS_STORAGE_ITEM_STRING && itemType != WUPS_STORAGE_ITEM_BINARY)
+            return WUPS_STORAGE_ERROR_INVALID_ARGUMENT;
+        std::lock_guard guard{mut};
+        auto& children = resolve(parent).children;
+        auto it = children.find(key);
+        if (it == children.end())
+            return WUPS_STORAGE_ERROR_NOT_FOUND;
+        auto v = std::get_if<value>(&it->second);
+        if (!v || v->type != itemType)
+            return WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE;
+        *outSize = reported_size(*v);
+        return WUPS_STORAGE_ERROR_SUCCESS;
+    }
+
+} // extern "C"
@@ -0,0 +1,77 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Host implementation of the WHBLog functions: everything goes to stderr.
+
+#include <cstdarg>
+#include <cstdio>
+
+#include <whb/log.h>
+#include <whb/log_module.h>
+#include <whb/log_udp.h>
+
+
+extern "C" {
+
+    BOOL
+    WHBLogWrite(const char* str)
+    {
+        std::fputs(str, stderr);
+        return TRUE;
+    }
+
+
+    BOOL
+    WHBLogPrint(const char* str)
+    {
+        std::fputs(str, stderr);
+        std::fputc('\n', stderr);
+        return TRUE;
+    }
+
+
+    BOOL
+    WHBLogPrintf(const char* fmt, ...)
+    {
+        std::va_list args;
+        va_start(args, fmt);
+        std::vfprintf(stderr, fmt, args);
+        va_end(args);
+        std::fputc('\n', stderr);
+        return TRUE;
+    }
+
+
+    BOOL
+    WHBLogModuleInit()
+    {
+        return TRUE;
+    }
+
+
+    BOOL
+    WHBLogModuleDeinit()
+    {
+        return TRUE;
+    }
+
+
+    BOOL
+    WHBLogUdpInit()
+    {
+        return FALSE;
+    }
+
+
+    BOOL
+    WHBLogUdpDeinit()
+    {
+        return FALSE;
+    }
+
+} // extern "C"
@@ -0,0 +1,130 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Binary blobs, and the header that guards them.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <wups/storage.h>
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+
+
+struct entry {
+    std::int32_t a;
+    float b;
+};
+
+template<>
+constexpr inline std::uint32_t wups::storage::blob_version<entry> = 2;
+
+
+struct entry_v1 {
+    std::int32_t a;
+    float b;
+};
+
+template<>
+constexpr inline std::uint32_t wups::storage::blob_version<entry_v1> = 1;
+
+
+static
+void
+test_round_trip()
+{
+    host::storage::reset();
+
+    const std::vector<entry> v{{1, 2.0f}, {3, 4.0f}};
+    CHECK(storage::try_store("v", v));
+    auto loaded = storage::load<std::vector<entry>>("v");
+    CHECK(loaded && loaded->size() == 2);
+    CHECK(loaded && (*loaded)[1].a == 3 && (*loaded)[1].b == 4.0f);
+
+    const std::array<std::int16_t, 3> a{7, 8, 9};
+    CHECK(storage::try_store("a", a));
+    auto la = storage::load<std::array<std::int16_t, 3>>("a");
+    CHECK(la && *la == a);
+
+    const std::vector<entry> empty;
+    CHECK(storage::try_store("e", empty));
+    auto le = storage::load<std::vector<entry>>("e");
+    CHECK(le && le->empty());
+}
+
+
+static
+void
+test_header()
+{
+    host::storage::reset();
+
+    const std::vector<entry> v{{1, 2.0f}, {3, 4.0f}};
+    CHECK(storage::try_store("v", v));
+
+    // The header is 16 bytes: magic, version, element size and payload size.
+    std::vector<std::uint8_t> raw;
+    CHECK(WUPSStorageAPI::Get("v", raw) == WUPS_STORAGE_ERROR_SUCCESS);
+    CHECK(raw.size() == 16 + sizeof(entry) * v.size());
+    std::uint32_t header[4];
+    std::memcpy(header, raw.data(), sizeof header);
+    CHECK(header[0] == 0x57584231);
+    CHECK(header[1] == 2);
+    CHECK(header[2] == sizeof(entry));
+    CHECK(header[3] == sizeof(entry) * v.size());
+
+    // Wrong version.
+    auto old = storage::load<std::vector<entry_v1>>("v");
+    CHECK(!old);
+    CHECK(old.error().code == WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE);
+
+    // Wrong element size.
+    auto ints = storage::load<std::vector<std::int32_t>>("v");
+    CHECK(!ints);
+    CHECK(ints.error().code == WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE);
+
+    // Wrong number of elements for an array.
+    auto arr = storage::load<std::array<entry, 3>>("v");
+    CHECK(!arr);
+    CHECK(arr.error().code == WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE);
+
+    // Truncated payload.
+    auto cut = raw;
+    cut.pop_back();
+    CHECK(WUPSStorageAPI::Store("cut", cut) == WUPS_STORAGE_ERROR_SUCCESS);
+    CHECK(!storage::load<std::vector<entry>>("cut"));
+
+    // Bad magic.
+    auto bad = raw;
+    bad[0] ^= 0xff;
+    CHECK(WUPSStorageAPI::Store("bad", bad) == WUPS_STORAGE_ERROR_SUCCESS);
+    CHECK(!storage::load<std::vector<entry>>("bad"));
+
+    // Shorter than a header.
+    const std::vector<std::uint8_t> tiny{1, 2, 3};
+    CHECK(WUPSStorageAPI::Store("tiny", tiny) == WUPS_STORAGE_ERROR_SUCCESS);
+    CHECK(!storage::load<std::vector<entry>>("tiny"));
+}
+
+
+int
+main()
+{
+    test_round_trip();
+    test_header();
+    return report();
+}
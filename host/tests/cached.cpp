@@ -0,0 +1,101 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// cached<> values: lazy loading, dirty tracking, and reload.
+
+#include <string>
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+
+
+static
+void
+test_lazy_load()
+{
+    host::storage::reset();
+    storage::store("volume", 3);
+    storage::cached<int> volume{"volume", 5};
+
+    CHECK(volume.get() == 3);
+
+    // Setting it doesn't touch the storage until save().
+    volume.set(4);
+    CHECK(storage::load<int>("volume").value_or(0) == 3);
+    storage::save();
+    CHECK(storage::load<int>("volume").value_or(0) == 4);
+    CHECK(host::storage::save_count() == 1);
+}
+
+
+static
+void
+test_default_written_back()
+{
+    host::storage::reset();
+    storage::group audio{{}, "audio"};
+    storage::cached<std::string> name{audio, "name", "default"};
+
+    // A missing key gets the default, and it's stored on the next save().
+    CHECK(name.get() == "default");
+    CHECK(!audio.load<std::string>("name"));
+    storage::save();
+    CHECK(audio.load<std::string>("name").value_or("") == "default");
+}
+
+
+static
+void
+test_reload()
+{
+    host::storage::reset();
+    storage::cached<int> volume{"volume", 5};
+    volume.set(6);
+    storage::save();
+
+    // Changed behind the entry's back: reload() makes it load again.
+    storage::store("volume", 8);
+    storage::save();
+    CHECK(volume.get() == 6);
+    storage::reload();
+    CHECK(volume.get() == 8);
+}
+
+
+static
+void
+test_failed_flush_stays_dirty()
+{
+    host::storage::reset();
+    storage::cached<int> volume{"volume", 5};
+    volume.set(7);
+
+    host::storage::fail_next_store(WUPS_STORAGE_ERROR_IO_ERROR);
+    CHECK(!storage::try_save());
+    CHECK(!storage::load<int>("volume"));
+
+    // Still dirty, so the next save() stores it.
+    CHECK(storage::try_save());
+    CHECK(storage::load<int>("volume").value_or(0) == 7);
+}
+
+
+int
+main()
+{
+    test_lazy_load();
+    test_default_written_back();
+    test_reload();
+    test_failed_flush_stays_dirty();
+    return report();
+}
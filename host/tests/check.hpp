@@ -0,0 +1,50 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>              // EXIT_FAILURE, EXIT_SUCCESS
+
+
+// Minimal test helpers: a failed CHECK() is reported, and the test goes on; report()
+// gives the exit status.
+
+#define CHECK(...) check_impl(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+
+inline unsigned failures = 0;
+
+
+inline
+void
+check_impl(bool ok,
+           const char* expr,
+           const char* file,
+           int line)
+{
+    if (ok)
+        return;
+    ++failures;
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+}
+
+
+inline
+int
+report()
+{
+    if (failures) {
+        std::fprintf(stderr, "%u checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Lazy categories, and the menu stats.
+
+#include <cstdio>               // snprintf()
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <wupsxx/host_config.hpp>
+#include <wupsxx/init.hpp>
+#include <wupsxx/item.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups::config;
+namespace host_config = wups::host::config;
+
+
+struct label_item : item {
+
+    label_item(const std::string& label) :
+        item{label}
+    {}
+
+    void
+    get_display(char* buf, std::size_t size)
+        const override
+    {
+        std::snprintf(buf, size, "value");
+    }
+
+};
+
+
+static unsigned builds = 0;
+
+
+static
+void
+add_items(category& cat,
+          unsigned n)
+{
+    for (unsigned i = 0; i < n; ++i)
+        cat.add(std::make_unique<label_item>("item " + std::to_string(i)));
+}
+
+
+static
+void
+open_callback(category& root)
+{
+    add_items(root, 1);
+    for (unsigned i = 0; i < 3; ++i)
+        root.add_lazy("lazy " + std::to_string(i),
+                      [i](category& cat)
+                      {
+                          ++builds;
+                          if (i == 1)
+                              throw std::runtime_error{"builder failed"};
+                          add_items(cat, 1);
+                          cat.add_lazy("deep", [](category& deep)
+                          {
+                              ++builds;
+                              add_items(deep, 10);
+                          });
+                      });
+}
+
+
+static
+void
+test_lazy()
+{
+    init("test", open_callback, [] {});
+
+    CHECK(host_config::open_menu());
+    auto stats = get_menu_stats();
+    CHECK(stats.items == 1);
+    CHECK(stats.lazy_pending == 3);
+    CHECK(stats.lazy_built == 0);
+    CHECK(builds == 0);
+    CHECK(host_config::live_items() == 1);
+
+    // Drawing the root's item builds its lazy siblings; the one that throws doesn't stop
+    // the others, it only delays them to the next frame.
+    auto rows = host_config::draw(6);
+    CHECK(rows.size() == 4);
+    CHECK(get_menu_stats().lazy_built == 1);
+    rows = host_config::draw(6);
+    CHECK(rows.size() == 4 && rows[3] == "item 0: value");
+    CHECK(get_menu_stats().lazy_built == 2);
+    CHECK(builds == 3);
+    CHECK(host_config::live_items() == 3);
+
+    // The nested lazy categories are only built once their parent is shown.
+    CHECK(host_config::enter(2));
+    host_config::draw(6);
+    CHECK(builds == 4);
+    CHECK(host_config::live_items() == 13);
+
+    host_config::close_menu();
+    CHECK(host_config::live_items() == 0);
+}
+
+
+static
+void
+test_eager()
+{
+    // With no items to trigger them, lazy categories are built right away.
+    init("test",
+         [](category& root)
+         {
+             root.add_lazy("a", [](category& cat) { add_items(cat, 2); });
+             root.add_lazy("b", [](category& cat) { add_items(cat, 3); });
+         },
+         [] {});
+
+    CHECK(host_config::open_menu());
+    auto stats = get_menu_stats();
+    CHECK(stats.lazy_built == 2);
+    CHECK(stats.items == 5);
+    CHECK(host_config::live_items() == 5);
+    host_config::close_menu();
+}
+
+
+int
+main()
+{
+    test_lazy();
+    test_eager();
+    return report();
+}
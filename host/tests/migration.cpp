@@ -0,0 +1,141 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Storage migrations, and their rollback.
+
+#include <chrono>
+#include <cstdint>
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+#include <wupsxx/storage_migration.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+using namespace std::literals;
+
+
+static
+void
+seed()
+{
+    host::storage::reset();
+    storage::store("delay", 1500);
+    storage::store("spd", 3);
+    storage::save();
+}
+
+
+static const storage::migration_step good_steps[] = {
+    {0, [](storage::group& g)
+        {
+            return storage::convert<int, std::chrono::seconds>(
+                g, "delay", "delay",
+                [](int ms) { return std::chrono::seconds{ms / 1000}; });
+        }},
+    {1, [](storage::group& g) { return storage::rename<int>(g, "spd", "speed"); }},
+};
+
+
+static
+void
+test_migrate()
+{
+    seed();
+    const auto saves = host::storage::save_count();
+
+    CHECK(storage::migrate(2, good_steps));
+    CHECK(storage::load<std::uint32_t>("schema_version").value_or(0) == 2);
+    CHECK(storage::load<std::chrono::seconds>("delay").value_or(0s) == 1s);
+    CHECK(storage::load<int>("speed").value_or(0) == 3);
+    CHECK(!storage::load<int>("spd"));
+    CHECK(host::storage::save_count() == saves + 1);
+
+    // Already at the target version: nothing to do.
+    CHECK(storage::migrate(2, good_steps));
+    CHECK(host::storage::save_count() == saves + 1);
+
+    // Newer than the target.
+    CHECK(!storage::migrate(1, good_steps));
+}
+
+
+static
+void
+test_rollback()
+{
+    const storage::migration_step failing_steps[] = {
+        good_steps[0],
+        {1, [](storage::group&) -> storage::migration_result
+            {
+                return std::unexpected{storage::storage_error{"step failed",
+                                                              WUPS_STORAGE_ERROR_IO_ERROR}};
+            }},
+    };
+
+    seed();
+    const auto saves = host::storage::save_count();
+
+    auto res = storage::migrate(2, failing_steps);
+    CHECK(!res);
+    CHECK(res.error().code == WUPS_STORAGE_ERROR_IO_ERROR);
+
+    // The first step was undone too, and nothing was saved.
+    CHECK(storage::load<int>("delay").value_or(0) == 1500);
+    CHECK(storage::load<int>("spd").value_or(0) == 3);
+    CHECK(!storage::load<std::uint32_t>("schema_version"));
+    CHECK(host::storage::save_count() == saves);
+
+    // Unsaved changes outside the migration are kept.
+    seed();
+    storage::store("volume", 7);
+    CHECK(!storage::migrate(2, failing_steps));
+    CHECK(storage::load<int>("volume").value_or(0) == 7);
+    CHECK(storage::load<int>("delay").value_or(0) == 1500);
+
+    // A missing step also rolls back.
+    seed();
+    CHECK(!storage::migrate(3, good_steps));
+    CHECK(storage::load<int>("delay").value_or(0) == 1500);
+    CHECK(!storage::load<std::uint32_t>("schema_version"));
+}
+
+
+static
+void
+test_failed_save()
+{
+    seed();
+    storage::store("volume", 7);
+    const auto saves = host::storage::save_count();
+
+    host::storage::fail_next_save(WUPS_STORAGE_ERROR_IO_ERROR);
+    auto res = storage::migrate(2, good_steps);
+    CHECK(!res);
+    CHECK(res.error().code == WUPS_STORAGE_ERROR_IO_ERROR);
+    CHECK(host::storage::save_count() == saves);
+
+    // The migrated keys are not left in memory, the unrelated key is.
+    CHECK(storage::load<int>("delay").value_or(0) == 1500);
+    CHECK(storage::load<int>("spd").value_or(0) == 3);
+    CHECK(!storage::load<int>("speed"));
+    CHECK(!storage::load<std::uint32_t>("schema_version"));
+    CHECK(storage::load<int>("volume").value_or(0) == 7);
+}
+
+
+int
+main()
+{
+    test_migrate();
+    test_rollback();
+    test_failed_save();
+    return report();
+}
@@ -0,0 +1,115 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Storage mirrors: updating, verifying and restoring.
+
+#include <cstdint>
+#include <filesystem>
+
+#include <wups/storage.h>
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+#include <wupsxx/storage_mirror.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+
+
+static
+std::filesystem::path
+fresh_mirror_file()
+{
+    auto filename = std::filesystem::temp_directory_path() / "libwupsxx-test.mirror";
+    std::error_code ec;
+    std::filesystem::remove(filename, ec);
+    return filename;
+}
+
+
+// Change a key behind libwupsxx's back, like a corrupted config file would.
+static
+void
+corrupt(const char* key,
+        std::int32_t value)
+{
+    WUPSStorageAPI_StoreItem(nullptr, key, WUPS_STORAGE_ITEM_S32, &value, sizeof value);
+}
+
+
+static
+void
+test_update_and_verify()
+{
+    host::storage::reset();
+    storage::mirror m{storage::group{}, fresh_mirror_file()};
+
+    storage::store("volume", 7);
+    storage::store("speed", 3);
+    storage::save();
+
+    // Nothing to restore.
+    auto res = m.verify();
+    CHECK(res && *res == 0);
+
+    // Update after a later save picks up the new value.
+    storage::store("volume", 9);
+    storage::save();
+    corrupt("volume", 1);
+    res = m.verify();
+    CHECK(res && *res == 1);
+    CHECK(storage::load<int>("volume").value_or(0) == 9);
+    CHECK(storage::load<int>("speed").value_or(0) == 3);
+}
+
+
+static
+void
+test_restore_after_failed_reload()
+{
+    host::storage::reset();
+    storage::mirror m{storage::group{}, fresh_mirror_file()};
+
+    storage::store("volume", 7);
+    storage::store("speed", 3);
+    storage::save();
+    const auto saves = host::storage::save_count();
+
+    // The config file can't be loaded: the mirrored keys come back, and get saved.
+    host::storage::fail_next_reload(WUPS_STORAGE_ERROR_IO_ERROR);
+    CHECK(storage::try_reload());
+    CHECK(storage::load<int>("volume").value_or(0) == 7);
+    CHECK(storage::load<int>("speed").value_or(0) == 3);
+    CHECK(host::storage::save_count() == saves + 1);
+}
+
+
+static
+void
+test_no_mirror_copy()
+{
+    host::storage::reset();
+    storage::mirror m{storage::group{}, fresh_mirror_file()};
+
+    // Nothing was ever saved, so there's nothing to restore from.
+    host::storage::fail_next_reload(WUPS_STORAGE_ERROR_IO_ERROR);
+    CHECK(!storage::try_reload());
+}
+
+
+int
+main()
+{
+    test_update_and_verify();
+    test_restore_after_failed_reload();
+    test_no_mirror_copy();
+    std::error_code ec;
+    std::filesystem::remove(fresh_mirror_file(), ec);
+    return report();
+}
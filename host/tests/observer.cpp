@@ -0,0 +1,96 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Storage observers: delivery, coalescing and unsubscribing.
+
+#include <atomic>
+#include <optional>
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+#include <wupsxx/storage_observer.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+
+
+static
+void
+test_keys()
+{
+    host::storage::reset();
+    std::atomic_uint volume_calls = 0;
+    std::atomic_uint hdr_calls = 0;
+    storage::group video{{}, "video"};
+    auto s1 = storage::observe("volume", [&volume_calls] { ++volume_calls; });
+    auto s2 = storage::observe(video, "hdr", [&hdr_calls] { ++hdr_calls; });
+
+    storage::store("volume", 1);
+    storage::flush_notifications();
+    CHECK(volume_calls == 1);
+    CHECK(hdr_calls == 0);
+
+    // Same key in another group, and removing it.
+    storage::store("hdr", true);
+    video.store("hdr", true);
+    video.remove("hdr");
+    storage::flush_notifications();
+    CHECK(volume_calls == 1);
+    CHECK(hdr_calls >= 1);
+
+    // Nothing is delivered after unsubscribing.
+    s1.reset();
+    storage::store("volume", 2);
+    storage::flush_notifications();
+    CHECK(volume_calls == 1);
+}
+
+
+static
+void
+test_variables()
+{
+    int speed = 0;
+    std::atomic_uint calls = 0;
+    auto sub = storage::observe_variable(speed, [&calls] { ++calls; });
+    storage::notify_variable(speed);
+    storage::flush_notifications();
+    CHECK(calls == 1);
+}
+
+
+static
+void
+test_unsubscribe_from_observer()
+{
+    std::atomic_uint calls = 0;
+    std::optional<storage::subscription> sub;
+    sub = storage::observe_address(&calls, [&]
+    {
+        ++calls;
+        // Must not wait for itself.
+        sub->reset();
+    });
+    storage::notify_address(&calls);
+    storage::flush_notifications();
+    storage::notify_address(&calls);
+    storage::flush_notifications();
+    CHECK(calls == 1);
+}
+
+
+int
+main()
+{
+    test_keys();
+    test_variables();
+    test_unsubscribe_from_observer();
+    return report();
+}
@@ -0,0 +1,124 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// The string parsers, and loading through them.
+
+#include <chrono>
+#include <string>
+#include <variant>
+
+#include <wupsxx/button_combo.hpp>
+#include <wupsxx/color.hpp>
+#include <wupsxx/duration.hpp>
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/parse.hpp>
+#include <wupsxx/storage.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+using namespace std::literals;
+
+using utils::parse;
+using utils::parse_errc;
+
+
+static
+void
+test_color()
+{
+    CHECK(parse<utils::color>("#ff0080").value_or(utils::color{}) == utils::color(255, 0, 128));
+    CHECK(parse<utils::color>("#Ff008010").value_or(utils::color{})
+          == utils::color(255, 0, 128, 16));
+    CHECK(parse<utils::color>("ff0080").error().code == parse_errc::invalid_char);
+    CHECK(parse<utils::color>("#ff00g0").error().pos == 5);
+    CHECK(parse<utils::color>("#ff00").error().code == parse_errc::invalid_length);
+    CHECK(parse<utils::color>("#ff00801020").error().code == parse_errc::invalid_length);
+    CHECK(parse<utils::color>("#ff0080102").error().code == parse_errc::invalid_length);
+    CHECK(parse<utils::color>("").error().code == parse_errc::empty);
+}
+
+
+static
+void
+test_duration()
+{
+    CHECK(parse<std::chrono::milliseconds>("2s").value_or(0ms) == 2000ms);
+    CHECK(parse<std::chrono::milliseconds>("15").value_or(0ms) == 15ms);
+    CHECK(parse<std::chrono::seconds>("2min").value_or(0s) == 120s);
+    CHECK(parse<std::chrono::seconds>("-2min").value_or(0s) == -120s);
+    CHECK(parse<std::chrono::seconds>("1500ms").error().code == parse_errc::inexact);
+    CHECK(parse<std::chrono::seconds>("2x").error().code == parse_errc::unknown_unit);
+
+    // Out of range for the type, before any conversion could overflow.
+    CHECK(parse<std::chrono::milliseconds>("9223372036854775d").error().code
+          == parse_errc::out_of_range);
+    using int_ms = std::chrono::duration<int, std::milli>;
+    CHECK(parse<int_ms>("30d").error().code == parse_errc::out_of_range);
+    CHECK(parse<int_ms>("20d").value_or(int_ms{}) == 20 * 24h);
+}
+
+
+static
+void
+test_button_combo()
+{
+    auto bc = parse<utils::button_combo>("VPAD_BUTTON_L + VPAD_BUTTON_R");
+    CHECK(bc && to_string(*bc) == "VPAD_BUTTON_L+VPAD_BUTTON_R");
+
+    auto empty = parse<utils::button_combo>("  ");
+    CHECK(empty && std::holds_alternative<std::monostate>(*empty));
+
+    CHECK(parse<utils::button_combo>("VPAD_BUTTON_L+WPAD_BUTTON_A").error().code
+          == parse_errc::mixed_devices);
+    CHECK(parse<utils::button_combo>("WPAD_NUNCHUK_BUTTON_Z+WPAD_CLASSIC_BUTTON_A").error().code
+          == parse_errc::mixed_extensions);
+
+    // Unknown buttons of a known device are skipped, so combos saved by newer versions
+    // still load; anything else is an error.
+    auto lenient = parse<utils::button_combo>("VPAD_BUTTON_A + VPAD_BUTTON_FOO");
+    CHECK(lenient && to_string(*lenient) == "VPAD_BUTTON_A");
+    CHECK(parse<utils::button_combo>("VPAD_BUTTON_A + FOO").error().code
+          == parse_errc::unknown_token);
+}
+
+
+static
+void
+test_load()
+{
+    host::storage::reset();
+
+    storage::store("c", utils::color{1, 2, 3});
+    CHECK(storage::load<utils::color>("c").value_or(utils::color{}) == utils::color(1, 2, 3));
+
+    storage::store<std::string>("bad", "nope");
+    auto bad = storage::load<utils::color>("bad");
+    CHECK(!bad);
+    CHECK(bad.error().code == WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE);
+
+    std::string long_combo;
+    for (int i = 0; i < 20; ++i)
+        long_combo += "VPAD_BUTTON_A + ";
+    long_combo += "VPAD_BUTTON_B";
+    storage::store("bc", long_combo);
+    auto bc = storage::load<utils::button_combo>("bc");
+    CHECK(bc && to_string(*bc) == "VPAD_BUTTON_A+VPAD_BUTTON_B");
+}
+
+
+int
+main()
+{
+    test_color();
+    test_duration();
+    test_button_combo();
+    test_load();
+    return report();
+}
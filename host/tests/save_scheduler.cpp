@@ -0,0 +1,94 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Background saves of cached<> values.
+
+#include <atomic>
+#include <chrono>
+#include <thread>               // this_thread::sleep_for()
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/save_scheduler.hpp>
+#include <wupsxx/storage.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+using namespace std::literals;
+
+
+static
+void
+test_coalesce()
+{
+    host::storage::reset();
+    storage::cached<int> volume{"volume", 5};
+    unsigned calls = 0;
+    storage::save_scheduler sched{50ms, [&calls](const auto& res) { calls += !!res; }};
+
+    volume.set(6);
+    sched.request();
+    volume.set(7);
+    sched.request();
+    sched.flush();
+
+    CHECK(calls == 1);
+    CHECK(host::storage::save_count() == 1);
+    CHECK(storage::load<int>("volume").value_or(0) == 7);
+}
+
+
+static
+void
+test_flush_takes_snapshots()
+{
+    host::storage::reset();
+    storage::cached<int> volume{"volume", 5};
+    storage::save_scheduler sched{50ms};
+
+    // No request(): flush() must still pick up the change.
+    volume.set(8);
+    sched.flush();
+    CHECK(host::storage::save_count() == 1);
+    CHECK(storage::load<int>("volume").value_or(0) == 8);
+}
+
+
+static
+void
+test_failed_save_is_retried()
+{
+    host::storage::reset();
+    storage::cached<int> volume{"volume", 5};
+    std::atomic_uint failed = 0;
+    storage::save_scheduler sched{0ms, [&failed](const auto& res) { failed += !res; }};
+
+    host::storage::fail_next_save(WUPS_STORAGE_ERROR_IO_ERROR);
+    volume.set(9);
+    sched.request();
+    // Let the failed save happen before flushing.
+    while (!failed)
+        std::this_thread::sleep_for(1ms);
+
+    sched.flush();
+    CHECK(failed == 1);
+    CHECK(host::storage::save_count() == 1);
+    CHECK(storage::try_reload());
+    CHECK(storage::load<int>("volume").value_or(0) == 9);
+}
+
+
+int
+main()
+{
+    test_coalesce();
+    test_flush_takes_snapshots();
+    test_failed_save_is_retried();
+    return report();
+}
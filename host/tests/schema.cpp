@@ -0,0 +1,104 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Schemas: loading, storing and reporting errors for a whole struct.
+
+#include <chrono>
+#include <string>
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+#include <wupsxx/storage_schema.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+using namespace std::literals;
+
+
+namespace {
+
+    struct settings {
+        bool enabled;
+        std::chrono::milliseconds delay;
+        std::string name;
+    };
+
+
+    const storage::schema settings_schema{
+        storage::field{"enabled", &settings::enabled, true},
+        storage::field{"delay",   &settings::delay,   100ms},
+        storage::field{"name",    &settings::name,    std::string{"player"}},
+    };
+
+} // namespace
+
+
+static
+void
+test_defaults()
+{
+    host::storage::reset();
+    settings s{};
+
+    // Missing keys get the default, which is stored.
+    CHECK(settings_schema.load(s));
+    CHECK(s.enabled);
+    CHECK(s.delay == 100ms);
+    CHECK(s.name == "player");
+    CHECK(storage::load<bool>("enabled").value_or(false));
+    CHECK(storage::load<std::chrono::milliseconds>("delay").value_or(0ms) == 100ms);
+}
+
+
+static
+void
+test_round_trip()
+{
+    host::storage::reset();
+    storage::group g{{}, "settings"};
+    const settings out{false, 250ms, "other"};
+    CHECK(settings_schema.store(out, g));
+
+    settings in{};
+    CHECK(settings_schema.load(in, g));
+    CHECK(!in.enabled);
+    CHECK(in.delay == 250ms);
+    CHECK(in.name == "other");
+}
+
+
+static
+void
+test_errors()
+{
+    host::storage::reset();
+    // Wrong type: it's reported, and the member gets its default.
+    storage::store("enabled", std::string{"yes"});
+    storage::store("delay", 50);
+
+    settings s{};
+    auto res = settings_schema.load(s);
+    CHECK(!res);
+    CHECK(res.error().size() == 1);
+    CHECK(res.error()[0].key == "enabled");
+    CHECK(s.enabled);
+    CHECK(s.delay == 50ms);
+    CHECK(s.name == "player");
+}
+
+
+int
+main()
+{
+    test_defaults();
+    test_round_trip();
+    test_errors();
+    return report();
+}
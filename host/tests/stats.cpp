@@ -0,0 +1,85 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Storage statistics.
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+#include <wupsxx/storage_stats.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+
+
+static
+void
+test_disabled()
+{
+    host::storage::reset();
+    storage::stats::enable(false);
+    storage::stats::reset();
+    storage::store("volume", 1);
+    (void) storage::load<int>("volume");
+    storage::save();
+    auto s = storage::stats::get();
+    CHECK(s.total_loads() == 0);
+    CHECK(s.total_stores() == 0);
+    CHECK(s.save.count == 0);
+}
+
+
+static
+void
+test_counters()
+{
+    host::storage::reset();
+    storage::stats::enable();
+    storage::stats::reset();
+
+    storage::store("volume", 1);
+    storage::store("name", std::string{"abc"});
+    CHECK(storage::load<int>("volume").value_or(0) == 1);
+    storage::save();
+    storage::reload();
+
+    auto s = storage::stats::get();
+    CHECK(s.stores[WUPS_STORAGE_ITEM_S32] == 1);
+    CHECK(s.stores[WUPS_STORAGE_ITEM_STRING] == 1);
+    CHECK(s.total_stores() == 2);
+    CHECK(s.loads[WUPS_STORAGE_ITEM_S32] == 1);
+    CHECK(s.bytes_written == 4 + 3);
+    CHECK(s.save.count == 1);
+    CHECK(s.reload.count == 1);
+    CHECK(s.save.min <= s.save.max);
+
+    // Missing keys and groups are not failures; errors are.
+    (void) storage::load<int>("missing");
+    (void) storage::group{{}, "missing"}.load<int>("key");
+    CHECK(storage::stats::get().total_failures() == 0);
+    host::storage::fail_next_store(WUPS_STORAGE_ERROR_IO_ERROR);
+    CHECK(!storage::try_store("volume", 2));
+    s = storage::stats::get();
+    CHECK(s.failures_of(WUPS_STORAGE_ERROR_IO_ERROR) == 1);
+    CHECK(s.total_failures() == 1);
+
+    storage::stats::reset();
+    CHECK(storage::stats::enabled());
+    CHECK(storage::stats::get().total_stores() == 0);
+    storage::stats::enable(false);
+}
+
+
+int
+main()
+{
+    test_disabled();
+    test_counters();
+    return report();
+}
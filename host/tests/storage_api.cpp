@@ -0,0 +1,155 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// The WUPS storage semantics the library relies on: NOT_FOUND, RESIZE_EXISTING_BUFFER and
+// sub-items, through both the raw API and wups::storage.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <wups/storage.h>
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+
+
+static
+void
+test_not_found()
+{
+    host::storage::reset();
+
+    int i = 0;
+    CHECK(WUPSStorageAPI::Get("missing", i) == WUPS_STORAGE_ERROR_NOT_FOUND);
+    CHECK(WUPSStorageAPI::DeleteItem("missing") == WUPS_STORAGE_ERROR_NOT_FOUND);
+
+    auto res = storage::load<int>("missing");
+    CHECK(!res);
+    CHECK(res.error().code == WUPS_STORAGE_ERROR_NOT_FOUND);
+
+    // Only a missing key is initialized; the default is stored.
+    int value = 0;
+    CHECK(storage::try_load_or_init("speed", value, 42));
+    CHECK(value == 42);
+    CHECK(storage::load<int>("speed").value_or(0) == 42);
+
+    // Removing a missing key is not an error.
+    CHECK(storage::group{}.try_remove("missing"));
+
+    // A different type is not the same as missing.
+    storage::store<std::string>("name", "abc");
+    auto wrong = storage::load<int>("name");
+    CHECK(!wrong);
+    CHECK(wrong.error().code == WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE);
+    value = 7;
+    CHECK(!storage::try_load_or_init("name", value, 1));
+    CHECK(value == 7);
+}
+
+
+static
+void
+test_resize_existing_buffer()
+{
+    host::storage::reset();
+
+    const std::string long_str(300, 'x');
+    CHECK(WUPSStorageAPI::Store("str", long_str) == WUPS_STORAGE_ERROR_SUCCESS);
+
+    // The buffer grows to fit.
+    std::string out;
+    CHECK(WUPSStorageAPI::Get("str", out) == WUPS_STORAGE_ERROR_SUCCESS);
+    CHECK(out == long_str);
+
+    // Without resizing, the existing buffer must be large enough.
+    std::string small(10, '\0');
+    CHECK(WUPSStorageAPI::Get("str", small, WUPSStorageAPI::GetOptions::NONE)
+          == WUPS_STORAGE_ERROR_BUFFER_TOO_SMALL);
+
+    std::string big(400, '\0');
+    CHECK(WUPSStorageAPI::Get("str", big, WUPSStorageAPI::GetOptions::NONE)
+          == WUPS_STORAGE_ERROR_SUCCESS);
+    CHECK(big == long_str);
+
+    const std::vector<std::uint8_t> bytes{1, 2, 3, 4, 5};
+    CHECK(WUPSStorageAPI::Store("bin", bytes) == WUPS_STORAGE_ERROR_SUCCESS);
+    std::vector<std::uint8_t> out_bytes;
+    CHECK(WUPSStorageAPI::Get("bin", out_bytes) == WUPS_STORAGE_ERROR_SUCCESS);
+    CHECK(out_bytes == bytes);
+
+    CHECK(storage::load<std::string>("str").value_or("") == long_str);
+}
+
+
+static
+void
+test_sub_items()
+{
+    host::storage::reset();
+
+    storage::group video{{}, "video"};
+    storage::group hdr = video.open("hdr");
+
+    // Loading doesn't create them.
+    auto missing = hdr.load<bool>("enabled");
+    CHECK(!missing);
+    CHECK(missing.error().code == WUPS_STORAGE_ERROR_NOT_FOUND);
+    wups_storage_item handle = nullptr;
+    CHECK(WUPSStorageAPI_GetSubItem(nullptr, "video", &handle)
+          == WUPS_STORAGE_ERROR_NOT_FOUND);
+    CHECK(hdr.try_remove("enabled"));
+
+    // Sub-items are created on the first store.
+    CHECK(hdr.try_store("enabled", true));
+    CHECK(hdr.load<bool>("enabled").value_or(false));
+
+    // The same key in different groups is a different item.
+    CHECK(storage::try_store("enabled", false));
+    CHECK(!storage::load<bool>("enabled").value_or(true));
+    CHECK(hdr.load<bool>("enabled").value_or(false));
+
+    // A sub-item is not a value.
+    auto res = storage::load<int>("video");
+    CHECK(!res);
+    CHECK(res.error().code == WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE);
+
+    // Groups survive a reload: their handles are looked up again.
+    CHECK(storage::try_save());
+    CHECK(storage::try_reload());
+    CHECK(hdr.load<bool>("enabled").value_or(false));
+
+    CHECK(hdr.try_remove("enabled"));
+    auto gone = hdr.load<bool>("enabled");
+    CHECK(!gone);
+    CHECK(gone.error().code == WUPS_STORAGE_ERROR_NOT_FOUND);
+
+    // Removing a sub-item forgets its handle, and its children's.
+    CHECK(hdr.try_store("enabled", true));
+    CHECK(storage::group{}.try_remove("video"));
+    CHECK(!hdr.load<bool>("enabled"));
+    CHECK(hdr.try_store("enabled", false));
+    CHECK(!hdr.load<bool>("enabled").value_or(true));
+    CHECK(WUPSStorageAPI_GetSubItem(nullptr, "video", &handle)
+          == WUPS_STORAGE_ERROR_SUCCESS);
+}
+
+
+int
+main()
+{
+    test_not_found();
+    test_resize_existing_buffer();
+    test_sub_items();
+    return report();
+}
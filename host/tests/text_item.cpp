@@ -0,0 +1,85 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// text_item: cutting the text at character boundaries.
+
+#include <string>
+
+#include <wupsxx/text_item.hpp>
+
+#include "check.hpp"
+
+
+using wups::config::text_item;
+
+
+static
+std::string
+display(const text_item& t)
+{
+    char buf[80];
+    t.get_display(buf, sizeof buf);
+    return buf;
+}
+
+
+static
+void
+test_fits()
+{
+    text_item t{"label", "abc", 10};
+    CHECK(display(t) == "abc");
+}
+
+
+static
+void
+test_cut()
+{
+    text_item t{"label", "abcdef", 4};
+    CHECK(display(t) == "abc…");
+}
+
+
+static
+void
+test_combining()
+{
+    // A combining mark stays with the character before it.
+    text_item t{"label", "e\u0301bcdef", 4};
+    CHECK(display(t) == "e\u0301bc…");
+}
+
+
+static
+void
+test_leading_zero_width()
+{
+    // Leading zero-width code points go with the first character: nothing is hidden,
+    // and there's no left ellipsis.
+    text_item t1{"label", "\u0301abc", 10};
+    CHECK(display(t1) == "\u0301abc");
+
+    text_item t2{"label", "\u200b\u0301abcdef", 4};
+    CHECK(display(t2) == "\u200b\u0301abc…");
+
+    // Nothing but zero-width code points.
+    text_item t3{"label", "\u200b\u200b", 10};
+    CHECK(display(t3) == "\u200b\u200b");
+}
+
+
+int
+main()
+{
+    test_fits();
+    test_cut();
+    test_combining();
+    test_leading_zero_width();
+    return report();
+}
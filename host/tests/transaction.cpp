@@ -0,0 +1,105 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Transactions: commit and rollback.
+
+#include <string>
+
+#include <wupsxx/host_storage.hpp>
+#include <wupsxx/storage.hpp>
+#include <wupsxx/storage_transaction.hpp>
+
+#include "check.hpp"
+
+
+using namespace wups;
+
+
+static
+void
+test_commit()
+{
+    host::storage::reset();
+    int volume = 0;
+    std::string name;
+    {
+        storage::transaction tx;
+        tx.load_or_init("volume", volume, 5);
+        tx.assign("name", name, "player");
+        // A string literal is staged as a std::string.
+        tx.store("title", "hello");
+        CHECK(tx.size() == 3);
+        // Nothing is written before commit().
+        CHECK(!storage::load<int>("volume"));
+        CHECK(tx.try_commit());
+        CHECK(tx.empty());
+    }
+    CHECK(volume == 5);
+    CHECK(name == "player");
+    CHECK(storage::load<int>("volume").value_or(0) == 5);
+    CHECK(storage::load<std::string>("name").value_or("") == "player");
+    CHECK(storage::load<std::string>("title").value_or("") == "hello");
+}
+
+
+static
+void
+test_rollback_on_store_error()
+{
+    host::storage::reset();
+    storage::store("volume", 5);
+
+    int volume = 5;
+    int speed = 1;
+    storage::transaction tx;
+    tx.assign("volume", volume, 7);
+    tx.assign("speed", speed, 3);
+
+    // "volume" is written, "speed" fails: "volume" must be put back.
+    host::storage::fail_next_store(WUPS_STORAGE_ERROR_IO_ERROR, 1);
+    auto res = tx.try_commit();
+    CHECK(!res);
+    CHECK(res.error().code == WUPS_STORAGE_ERROR_IO_ERROR);
+    CHECK(storage::load<int>("volume").value_or(0) == 5);
+    CHECK(!storage::load<int>("speed"));
+    CHECK(volume == 5);
+    CHECK(speed == 1);
+    CHECK(tx.empty());
+}
+
+
+static
+void
+test_rollback_variables()
+{
+    host::storage::reset();
+    int volume = 2;
+    std::string name = "old";
+    {
+        storage::transaction tx;
+        tx.assign("volume", volume, 9);
+        tx.assign("name", name, "new");
+        tx.assign("volume", volume, 10);
+        CHECK(volume == 10);
+        CHECK(name == "new");
+        // Destroyed without commit().
+    }
+    CHECK(volume == 2);
+    CHECK(name == "old");
+    CHECK(!storage::load<int>("volume"));
+}
+
+
+int
+main()
+{
+    test_commit();
+    test_rollback_on_store_error();
+    test_rollback_variables();
+    return report();
+}
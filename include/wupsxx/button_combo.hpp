@@ -11,6 +11,7 @@
 
 #include <concepts>
 #include <cstdint>
+#include <expected>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -19,6 +20,8 @@
 #include <padscore/wpad.h>
 #include <vpad/input.h>
 
+#include "parse.hpp"
+
 
 struct WPADStatus;
 
@@ -66,8 +69,15 @@ namespace wups::utils {
             explicit
             button_set(const std::vector<std::string_view>& args);
 
+            // Add the button called `name` (like "VPAD_BUTTON_A".)
+            std::expected<void, parse_errc> add(std::string_view name) noexcept;
+
             bool contains(VPADButtons btn) const noexcept;
 
+            constexpr
+            bool
+            operator ==(const button_set& other) const noexcept = default;
+
         };
 
 
@@ -108,6 +118,10 @@ namespace wups::utils {
                     buttons{ static_cast<std::uint16_t>((bs | ...)) }
                 {}
 
+                constexpr
+                bool
+                operator ==(const button_set& other) const noexcept = default;
+
             };
 
 
@@ -136,6 +150,10 @@ namespace wups::utils {
                     noexcept :
                     buttons{ static_cast<std::uint16_t>((bs | ...)) }
                 {}
+
+                constexpr
+                bool
+                operator ==(const button_set& other) const noexcept = default;
             };
 
 
@@ -164,6 +182,10 @@ namespace wups::utils {
                     noexcept :
                     buttons{ static_cast<std::uint16_t>((bs | ...)) }
                 {}
+
+                constexpr
+                bool
+                operator ==(const button_set& other) const noexcept = default;
             };
 
 
@@ -192,6 +214,10 @@ namespace wups::utils {
                     noexcept :
                     buttons{ static_cast<std::uint32_t>((bs | ...)) }
                 {}
+
+                constexpr
+                bool
+                operator ==(const button_set& other) const noexcept = default;
             };
 
 
@@ -241,11 +267,18 @@ namespace wups::utils {
 
             button_set(const std::vector<std::string_view>& args);
 
+            // Add the button called `name` (like "WPAD_BUTTON_A".)
+            std::expected<void, parse_errc> add(std::string_view name) noexcept;
+
             bool contains(WPADButton btn) const noexcept;
             bool contains(WPADNunchukButton btn) const noexcept;
             bool contains(WPADClassicButton btn) const noexcept;
             bool contains(WPADProButton btn) const noexcept;
 
+            constexpr
+            bool
+            operator ==(const button_set& other) const noexcept = default;
+
         };
 
 
@@ -319,6 +352,13 @@ namespace wups::utils {
 
     std::string to_glyph(const button_combo& bc, bool prefix = true);
 
+
+    // Accepts button names separated by '+' or spaces, like "VPAD_BUTTON_L + VPAD_BUTTON_R".
+    // Unknown names that start with "VPAD_" or "WPAD_" are ignored.
+    template<>
+    std::expected<button_combo, parse_error>
+    parse<button_combo>(std::string_view str);
+
 } // namespace wups::utils
 
 #endif
@@ -9,6 +9,9 @@
 #ifndef WUPSXX_CATEGORY_HPP
 #define WUPSXX_CATEGORY_HPP
 
+#include <chrono>
+#include <cstddef>              // size_t
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -19,13 +22,48 @@
 
 namespace wups::config {
 
+    class category;
+
+
+    // What it took to build the menu, the last time it was opened.
+    struct menu_stats {
+        std::chrono::microseconds open_time{0}; // in the open callback
+        std::chrono::microseconds lazy_time{0}; // building lazy categories, after that
+        unsigned items = 0;
+        unsigned lazy_pending = 0; // lazy categories added
+        unsigned lazy_built = 0;   // lazy categories that were actually built
+        std::size_t item_memory = 0; // bytes reserved for the items
+    };
+
+
+    namespace detail {
+
+        // Build the lazy children of a complete category, or schedule them.
+        void finish_category(category& cat);
+
+        void begin_menu_session();
+
+        // Forget everything about the menu that was closed.
+        void end_menu_session() noexcept;
+
+        menu_stats& current_menu_stats() noexcept;
+
+    } // namespace detail
+
+
     class category final {
 
         WUPSConfigCategoryHandle handle;
         bool own_handle; // if true, will destroy the handle in the destructor
+        item* first_item = nullptr;
+        unsigned categories = 0;
+        detail::lazy_node* lazy = nullptr; // only when there are lazy children
 
     public:
 
+        using builder_type = std::function<void(category& cat)>;
+
+
         // This constructor does not take ownership of the handle.
         category(WUPSConfigCategoryHandle handle);
 
@@ -40,6 +78,25 @@ namespace wups::config {
 
         void add(category&& child);
 
+
+        // Add a child category, whose contents are created by `builder` only when they
+        // might be needed.
+        //
+        // WUPS has no callback for entering a category, and it takes a snapshot of the
+        // items when it does; so the builder runs one level ahead: as soon as the first
+        // item of this category is shown. If that item is not on the first screen (this
+        // category has no items, or 6 or more child categories), it runs right away.
+        //
+        // So the lazy children of the root are built as soon as the menu is drawn: that
+        // only takes them out of the open callback. What's saved is the contents of the
+        // lazy categories one level further down, whose parent is never entered.
+        // If a builder throws, the other lazy children are still built the next time.
+        // Note: this only works with the root category from init().
+        void add_lazy(const std::string& label, builder_type builder);
+
+
+        friend void detail::finish_category(category& cat);
+
     };
 
 } // namespace wups
@@ -0,0 +1,182 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_CHOICE_HPP
+#define WUPSXX_CHOICE_HPP
+
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>          // type_identity_t
+#include <utility>              // forward()
+
+#include "storage_error.hpp"
+#include "storage_group.hpp"
+#include "storage_key.hpp"
+
+
+// A table of values with labels, to pick one of N values, like an enum:
+//
+//     enum class mode { off, slow, fast };
+//
+//     constexpr wups::utils::choice<mode> mode_choices[] = {
+//         {mode::off,  "Off"},
+//         {mode::slow, "Slow"},
+//         {mode::fast, "Fast"},
+//     };
+//
+// The table is not copied, so it must outlive the items and functions that use it.
+
+
+namespace wups::utils {
+
+    template<typename T>
+    struct choice {
+        T value;
+        std::string_view label;
+    };
+
+
+    // Note: T is deduced from the value, so the table can be a plain array.
+    template<typename T>
+    using choice_span = std::type_identity_t<std::span<const choice<T>>>;
+
+
+    template<typename T>
+    constexpr
+    std::optional<std::size_t>
+    index_of(choice_span<T> choices,
+             const T& value)
+        noexcept
+    {
+        for (std::size_t i = 0; i < choices.size(); ++i)
+            if (choices[i].value == value)
+                return i;
+        return {};
+    }
+
+
+    template<typename T>
+    constexpr
+    std::optional<std::size_t>
+    index_of_label(std::span<const choice<T>> choices,
+                   std::string_view label)
+        noexcept
+    {
+        for (std::size_t i = 0; i < choices.size(); ++i)
+            if (choices[i].label == label)
+                return i;
+        return {};
+    }
+
+} // namespace wups::utils
+
+
+namespace wups::storage {
+
+    // How a choice is written to the storage: its value survives renaming the labels, its
+    // label survives reordering or renumbering the values.
+    enum class choice_format {
+        value,
+        label,
+    };
+
+
+    template<typename T>
+    std::expected<void, storage_error>
+    try_store_choice(const key& k,
+                     const T& value,
+                     utils::choice_span<T> choices,
+                     choice_format format = choice_format::value,
+                     group parent = {})
+    {
+        if (format == choice_format::value)
+            return parent.try_store(k, value);
+        auto idx = utils::index_of(choices, value);
+        if (!idx)
+            return std::unexpected{storage_error{"value is not one of the choices",
+                                                 WUPS_STORAGE_ERROR_INVALID_ARGUMENT}};
+        return parent.try_store(k, std::string{choices[*idx].label});
+    }
+
+
+    template<typename T>
+    void
+    store_choice(const key& k,
+                 const T& value,
+                 utils::choice_span<T> choices,
+                 choice_format format = choice_format::value,
+                 group parent = {})
+    {
+        auto res = try_store_choice(k, value, choices, format, parent);
+        if (!res)
+            detail::raise(res.error());
+    }
+
+
+    // Like try_load_or_init(), but a stored value that is not in `choices` is also
+    // replaced by `init`.
+    template<typename T,
+             typename U>
+    std::expected<void, storage_error>
+    try_load_or_init_choice(const key& k,
+                            T& variable,
+                            U&& init,
+                            utils::choice_span<T> choices,
+                            choice_format format = choice_format::value,
+                            group parent = {})
+    {
+        std::optional<std::size_t> idx;
+        storage_error error{"", WUPS_STORAGE_ERROR_NOT_FOUND};
+        if (format == choice_format::value) {
+            auto res = parent.load<T>(k);
+            if (res)
+                idx = utils::index_of(choices, *res);
+            else
+                error = std::move(res.error());
+        } else {
+            auto res = parent.load<std::string>(k);
+            if (res)
+                idx = utils::index_of_label(choices, *res);
+            else
+                error = std::move(res.error());
+        }
+
+        if (idx) {
+            variable = choices[*idx].value;
+            return {};
+        }
+        if (error.code != WUPS_STORAGE_ERROR_NOT_FOUND)
+            return std::unexpected{std::move(error)};
+        variable = std::forward<U>(init);
+        return try_store_choice(k, variable, choices, format, parent);
+    }
+
+
+    template<typename T,
+             typename U>
+    void
+    load_or_init_choice(const key& k,
+                        T& variable,
+                        U&& init,
+                        utils::choice_span<T> choices,
+                        choice_format format = choice_format::value,
+                        group parent = {})
+    {
+        auto res = try_load_or_init_choice(k, variable, std::forward<U>(init),
+                                           choices, format, parent);
+        if (!res)
+            detail::raise(res.error());
+    }
+
+} // namespace wups::storage
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_CHOICE_ITEM_HPP
+#define WUPSXX_CHOICE_ITEM_HPP
+
+#include <concepts>
+#include <cstdio>               // snprintf()
+#include <memory>
+#include <string>
+
+#include "cafe_glyphs.h"
+#include "choice.hpp"
+#include "var_item.hpp"
+
+
+namespace wups::config {
+
+    // Pick one value from a table of choices:
+    //
+    //     choice_item<mode>::create("Mode", cfg::mode, mode::off, mode_choices);
+    //
+    // ◀/▶ go to the previous/next choice, wrapping around; L/R jump a page at a time.
+
+    template<std::equality_comparable T>
+    class choice_item : public var_item<T> {
+
+        using var_item<T>::variable;
+
+        utils::choice_span<T> choices;
+        std::size_t page_size;
+        mutable std::size_t index = 0; // last known position of the variable
+
+    public:
+
+        choice_item(const std::string& label,
+                    T& variable,
+                    T default_value,
+                    utils::choice_span<T> choices,
+                    std::size_t page_size = 10) :
+            var_item<T>{label, variable, default_value},
+            choices{choices},
+            page_size{page_size}
+        {}
+
+
+        static
+        std::unique_ptr<choice_item>
+        create(const std::string& label,
+               T& variable,
+               T default_value,
+               utils::choice_span<T> choices,
+               std::size_t page_size = 10)
+        {
+            return std::make_unique<choice_item>(label, variable, default_value,
+                                                 choices, page_size);
+        }
+
+
+        virtual
+        void
+        get_display(char* buf,
+                    std::size_t size)
+            const override
+        {
+            auto str = current_label();
+            std::snprintf(buf, size, "%.*s", int(str.size()), str.data());
+        }
+
+
+        virtual
+        void
+        get_focused_display(char* buf,
+                            std::size_t size)
+            const override
+        {
+            auto str = current_label();
+            std::snprintf(buf, size,
+                          CAFE_GLYPH_BTN_LEFT " %.*s " CAFE_GLYPH_BTN_RIGHT,
+                          int(str.size()), str.data());
+        }
+
+
+        virtual
+        focus_status
+        on_input(const simple_pad_data& input)
+            override
+        {
+            const std::size_t n = choices.size();
+            if (n > 0) {
+                const std::size_t old_idx = current_index();
+                std::size_t idx = old_idx;
+
+                if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_LEFT))
+                    idx = idx > 0 ? idx - 1 : n - 1;
+                if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_RIGHT))
+                    idx = idx + 1 < n ? idx + 1 : 0;
+
+                // Pages don't wrap around, so the ends are easy to reach.
+                if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_L))
+                    idx = idx > page_size ? idx - page_size : 0;
+                if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_R))
+                    idx = n - 1 - idx > page_size ? idx + page_size : n - 1;
+
+                if (idx != old_idx) {
+                    index = idx;
+                    variable = choices[idx].value;
+                }
+            }
+
+            return var_item<T>::on_input(input);
+        }
+
+
+        // don't hide item::on_input
+        using item::on_input;
+
+
+    private:
+
+        // O(1) while the variable only changes through this item.
+        std::size_t
+        current_index()
+            const noexcept
+        {
+            if (index < choices.size() && choices[index].value == variable)
+                return index;
+            if (auto idx = utils::index_of(choices, variable))
+                index = *idx;
+            return index;
+        }
+
+
+        std::string_view
+        current_label()
+            const noexcept
+        {
+            std::size_t idx = current_index();
+            if (idx < choices.size() && choices[idx].value == variable)
+                return choices[idx].label;
+            return "?";
+        }
+
+    };
+
+} // namespace wups::config
+
+#endif
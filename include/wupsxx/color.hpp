@@ -11,7 +11,11 @@
 
 #include <compare>
 #include <cstdint>
+#include <expected>
 #include <string>
+#include <string_view>
+
+#include "parse.hpp"
 
 
 namespace wups::utils {
@@ -92,6 +96,12 @@ namespace wups::utils {
 
     std::string to_string(color c, bool with_alpha = true, bool uppercase = true);
 
+
+    // Accepts "#RRGGBB" and "#RRGGBBAA".
+    template<>
+    std::expected<color, parse_error>
+    parse<color>(std::string_view str);
+
 } // namespace wups::utils
 
 #endif
@@ -9,9 +9,20 @@
 #ifndef WUPSXX_DURATION_HPP
 #define WUPSXX_DURATION_HPP
 
+#include <charconv>             // from_chars()
 #include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <ratio>
 #include <string>
+#include <string_view>
+#include <system_error>         // errc
 #include <type_traits>
+#include <utility>              // cmp_greater(), cmp_less()
+
+#include "parse.hpp"
 
 
 // Here we create a "duration" concept, so we can constrain templated functions.
@@ -47,6 +58,100 @@ namespace wups::utils {
     template<concepts::duration D>
     std::string to_string(D d);
 
+
+    // The unit that to_string() appends; empty for other periods.
+    template<concepts::duration D>
+    constexpr
+    const char*
+    unit_symbol()
+        noexcept
+    {
+        using P = typename D::period;
+        if constexpr (std::same_as<P, std::milli>)
+            return "ms";
+        else if constexpr (std::same_as<P, std::ratio<1>>)
+            return "s";
+        else if constexpr (std::same_as<P, std::ratio<60>>)
+            return "min";
+        else if constexpr (std::same_as<P, std::ratio<3600>>)
+            return "h";
+        else if constexpr (std::same_as<P, std::ratio<86400>>)
+            return "d";
+        else
+            return "";
+    }
+
+
+    namespace detail {
+
+        template<concepts::duration D,
+                 concepts::duration S>
+        std::expected<D, parse_error>
+        convert_duration(S src,
+                         std::size_t pos)
+        {
+            using rep = typename D::rep;
+            using R = std::ratio_divide<typename S::period, typename D::period>;
+            // Check the range first, since duration_cast<>() overflows silently.
+            if constexpr (std::integral<rep>) {
+                constexpr std::int64_t max = std::numeric_limits<std::int64_t>::max();
+                const std::int64_t count = src.count();
+                if (count > max / R::num || count < -max / R::num)
+                    return std::unexpected{parse_error{parse_errc::out_of_range, 0}};
+                const std::int64_t scaled = count * R::num / R::den;
+                if (std::cmp_greater(scaled, std::numeric_limits<rep>::max())
+                    || std::cmp_less(scaled, std::numeric_limits<rep>::lowest()))
+                    return std::unexpected{parse_error{parse_errc::out_of_range, 0}};
+            }
+            auto dst = std::chrono::duration_cast<D>(src);
+            if (std::chrono::duration_cast<S>(dst) != src)
+                return std::unexpected{parse_error{parse_errc::inexact, pos}};
+            return dst;
+        }
+
+    } // namespace detail
+
+
+    // Accepts a count followed by one of the units that to_string() uses ("ms", "s",
+    // "min", "h", "d"); without a unit, the count is in units of `D`.
+    // Values that `D` can't represent exactly are rejected.
+    template<concepts::duration D>
+    std::expected<D, parse_error>
+    parse(std::string_view str)
+    {
+        using std::chrono::duration;
+
+        if (str.empty())
+            return std::unexpected{parse_error{parse_errc::empty}};
+
+        std::int64_t count = 0;
+        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), count);
+        std::size_t pos = ptr - str.data();
+        if (ec == std::errc::result_out_of_range)
+            return std::unexpected{parse_error{parse_errc::out_of_range, 0}};
+        if (ec != std::errc{})
+            return std::unexpected{parse_error{parse_errc::invalid_char, pos}};
+
+        auto unit = str.substr(pos);
+        if (unit.empty())
+            return detail::convert_duration<D>(duration<std::int64_t, typename D::period>{count},
+                                               pos);
+        if (unit == "ms")
+            return detail::convert_duration<D>(duration<std::int64_t, std::milli>{count}, pos);
+        if (unit == "s")
+            return detail::convert_duration<D>(duration<std::int64_t>{count}, pos);
+        if (unit == "min")
+            return detail::convert_duration<D>(duration<std::int64_t, std::ratio<60>>{count},
+                                               pos);
+        if (unit == "h")
+            return detail::convert_duration<D>(duration<std::int64_t, std::ratio<3600>>{count},
+                                               pos);
+        if (unit == "d")
+            return detail::convert_duration<D>(duration<std::int64_t, std::ratio<86400>>{count},
+                                               pos);
+        return std::unexpected{parse_error{parse_errc::unknown_unit, pos}};
+    }
+
 } // namespace wups::utils
 
 
@@ -0,0 +1,59 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_FIXED_ITEM_HPP
+#define WUPSXX_FIXED_ITEM_HPP
+
+#include <memory>
+
+#include "numeric_item.hpp"
+
+
+namespace wups::config {
+
+    // An integer shown as `variable / scale`, for fractional settings that must step
+    // exactly and store compactly; the variable (and the storage) only sees the ticks:
+    //
+    //     int gamma = 100; // 1.00
+    //     wups::config::fixed_item::create("Gamma", gamma, 100, 50, 300, 100, 25, 5);
+    //
+    // shows "1.00", and steps by 0.05 with ◀/▶.
+
+    class fixed_item : public numeric_item<int> {
+
+        int scale;
+
+    public:
+
+        fixed_item(const std::string& label,
+                   int& variable, int default_value,
+                   int min_value, int max_value,
+                   int scale,
+                   int fast_increment = 10,
+                   int slow_increment = 1,
+                   const utils::number_format& format = {});
+
+        static
+        std::unique_ptr<fixed_item>
+        create(const std::string& label,
+               int& variable, int default_value,
+               int min_value, int max_value,
+               int scale,
+               int fast_increment = 10,
+               int slow_increment = 1,
+               const utils::number_format& format = {});
+
+    protected:
+
+        virtual void format_value(char* buf, std::size_t size, int value) const override;
+
+    };
+
+} // namespace wups::config
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_FLOAT_ITEM_HPP
+#define WUPSXX_FLOAT_ITEM_HPP
+
+#include "numeric_item.hpp"
+
+
+// Values are kept on multiples of the slow increment, counted from the minimum, so
+// stepping by 0.1 many times doesn't accumulate error.
+// Use the precision in the number format to pick how many decimals are shown:
+//
+//     wups::config::float_item::create("Scale", scale, 1.0f, 0.5f, 2.0f, 0.5f, 0.05f,
+//                                      {.precision = 2});
+
+
+namespace wups::config {
+
+    using float_item = numeric_item<float>;
+
+    using double_item = numeric_item<double>;
+
+} // namespace wups::config
+
+#endif
@@ -25,6 +25,11 @@ namespace wups::config {
          std::function<void(category& root)> open_callback,
          std::function<void()> close_callback);
 
+
+    // Statistics for the last time the menu was opened; lazy categories keep adding to
+    // them while the menu is open.
+    menu_stats get_menu_stats() noexcept;
+
 } // namespace wups::config
 
 #endif
@@ -10,6 +10,7 @@
 #define WUPSXX_ITEM_HPP
 
 #include <cstddef>              // size_t
+#include <cstdint>              // uint16_t
 #include <string>
 
 #include <wups/config/WUPSConfigItem.h>
@@ -19,6 +20,16 @@
 
 namespace wups::config {
 
+    namespace detail {
+
+        struct lazy_node;
+
+        // Build the lazy categories that are siblings of an item about to be shown.
+        void build_lazy(lazy_node* node);
+
+    } // namespace detail
+
+
     enum class focus_status {
         lose,
         keep,
@@ -35,9 +46,22 @@ namespace wups::config {
 
     class item {
 
+        // The last string rendered; WUPS asks for it every frame. The buffer is only
+        // allocated once the item is shown, with the size WUPS asks for.
+        struct display_cache {
+            char* buf = nullptr;
+            std::uint16_t capacity = 0; // of `buf`
+            std::uint16_t size = 0;     // of the buffer it was rendered for
+            std::uint16_t length = 0;   // including the null terminator; 0 when dirty
+        };
+
         WUPSConfigItemHandle handle;
         bool focused;
         input_mode current_mode;
+        bool cache_enabled = true;
+        mutable display_cache unfocused_cache;
+        mutable display_cache focused_cache;
+        detail::lazy_node* lazy = nullptr; // set while sibling categories are not built
 
     protected:
 
@@ -46,10 +70,27 @@ namespace wups::config {
         // Disallow moving, since the callbacks store the `this` pointer.
         item(item&&) = delete;
 
+
+        // Items whose display changes without any input (like progress messages set by
+        // another thread) must disable the cache.
+        void set_display_cache(bool enable) noexcept;
+
+
+        // Checked on every frame before using the cache; animated items return true when
+        // they need to be rendered again.
+        virtual bool is_display_outdated() const noexcept;
+
     public:
 
         virtual ~item();
 
+
+        // While the menu is open, items are allocated from an arena that is freed after
+        // the menu is closed.
+        static void* operator new(std::size_t size);
+
+        static void operator delete(void* ptr) noexcept;
+
         // Gives up ownership of the handle.
         void release() noexcept;
 
@@ -83,7 +124,19 @@ namespace wups::config {
         input_mode get_input_mode() const noexcept;
         void set_input_mode(input_mode mode) noexcept;
 
+
+        // The display is cached, and only rendered again after input, focus changes, or
+        // restore_default(). Call this after changing what is displayed in other ways,
+        // like assigning to the variable while the menu is open; otherwise the old value
+        // keeps being shown.
+        void invalidate_display() noexcept;
+
+
+        // Copy the display into `buf`, rendering it only if the cache is dirty.
+        void render_display(char* buf, std::size_t size, bool selected) const;
+
         friend class category;
+        friend struct detail::lazy_node;
 
     };
 
@@ -0,0 +1,321 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_MENU_SCHEMA_HPP
+#define WUPSXX_MENU_SCHEMA_HPP
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>          // is_enum_v, type_identity_t
+#include <utility>              // index_sequence, move()
+#include <vector>
+
+#include "button_combo.hpp"
+#include "category.hpp"
+#include "choice_item.hpp"
+#include "color.hpp"
+#include "storage_schema.hpp"
+
+
+// A menu schema is a storage schema where every field also describes its config item, so
+// the settings are declared only once:
+//
+//     struct settings {
+//         bool enabled;
+//         std::chrono::milliseconds delay;
+//         wups::utils::color color;
+//     };
+//
+//     const wups::config::menu_schema settings_menu{
+//         wups::config::setting{"enabled", &settings::enabled, true, "Enabled"},
+//         wups::config::setting{"delay",   &settings::delay,   100ms, "Delay",
+//                               {.min_value = 0ms, .max_value = 1000ms}},
+//         wups::config::setting{"color",   &settings::color,   wups::utils::color{0xff, 0, 0},
+//                               "Color"},
+//     };
+//
+//     settings_menu.load(current);       // when the plugin starts
+//     settings_menu.build(root, current); // in the menu open callback
+//
+// The kind of item is picked from the type of the member: bool_item, numeric_item (int, float,
+// double and durations), color_item, file_item or button_combo_item; enums use a choice_item, with
+// the table given as {.choices = ...}. Numeric settings must give their range.
+//
+// Note: the schema is not a constant table; the keys and item options (like file extensions)
+// are std::strings, so a menu_schema is constructed at run time, usually during static
+// initialization. What's shared is the code: each item kind is created by one function in
+// the library, no matter how many settings use it.
+
+
+namespace wups::config {
+
+    // Extra arguments for the item; the default is for numeric items, where the range
+    // can't be left empty.
+    template<typename T>
+    struct item_options {
+        T min_value{};
+        T max_value{};
+        T fast_increment{10};
+        T slow_increment{1};
+    };
+
+
+    template<>
+    struct item_options<bool> {
+        const char* true_str = "true";
+        const char* false_str = "false";
+    };
+
+
+    template<>
+    struct item_options<utils::color> {
+        bool has_alpha = false;
+    };
+
+
+    template<>
+    struct item_options<std::filesystem::path> {
+        std::size_t max_width = 40;
+        std::vector<std::string> extensions;
+    };
+
+
+    template<>
+    struct item_options<utils::button_combo> {};
+
+
+    template<typename T>
+        requires std::is_enum_v<T>
+    struct item_options<T> {
+        utils::choice_span<T> choices;
+        std::size_t page_size = 10;
+    };
+
+
+    namespace detail {
+
+        template<typename T>
+        concept has_range = requires (const item_options<T>& o) {
+            o.min_value;
+            o.max_value;
+        };
+
+
+        // Defined only for the types listed above.
+        // Throw std::logic_error if a numeric range is empty.
+        template<typename T>
+        std::unique_ptr<item>
+        make_item(const std::string& label,
+                  T& variable,
+                  const T& default_value,
+                  const item_options<T>& options);
+
+    } // namespace detail
+
+
+    template<typename S,
+             typename T>
+    struct setting {
+
+        storage::field<S, T> field;
+        std::string_view label;
+        item_options<T> options;
+
+
+        // Numeric settings have no default options: the range must be given.
+        template<typename U>
+            requires detail::has_range<T>
+        setting(const storage::key& k,
+                T S::* member,
+                U&& default_value,
+                std::string_view label,
+                std::type_identity_t<item_options<T>> options) :
+            field{k, member, std::forward<U>(default_value)},
+            label{label},
+            options(std::move(options))
+        {}
+
+
+        template<typename U>
+            requires (!detail::has_range<T>)
+        setting(const storage::key& k,
+                T S::* member,
+                U&& default_value,
+                std::string_view label,
+                std::type_identity_t<item_options<T>> options = {}) :
+            field{k, member, std::forward<U>(default_value)},
+            label{label},
+            options(std::move(options))
+        {}
+
+    };
+
+    template<typename S,
+             typename... Ts>
+    class menu_schema {
+
+        template<typename T>
+        struct item_entry {
+            std::string_view label;
+            item_options<T> options;
+        };
+
+        storage::schema<S, Ts...> fields;
+        std::tuple<item_entry<Ts>...> items;
+
+    public:
+
+        menu_schema(setting<S, Ts>... settings) :
+            fields{std::move(settings.field)...},
+            items{item_entry<Ts>{settings.label, std::move(settings.options)}...}
+        {}
+
+
+        const storage::schema<S, Ts...>&
+        get_schema()
+            const noexcept
+        {
+            return fields;
+        }
+
+
+        void
+        reset(S& settings)
+            const
+        {
+            fields.reset(settings);
+        }
+
+
+        // Like storage::schema::load(), but enums that were stored with a value that is
+        // not one of the choices are also replaced by their default.
+        storage::schema_result
+        load(S& settings,
+             storage::group parent = {})
+            const
+        {
+            std::vector<storage::field_error> errors;
+            auto res = fields.load(settings, parent);
+            if (!res)
+                errors = std::move(res.error());
+
+            check_choices(settings, parent, errors, std::index_sequence_for<Ts...>{});
+
+            if (!errors.empty())
+                return std::unexpected{std::move(errors)};
+            return {};
+        }
+
+
+        storage::schema_result
+        store(const S& settings,
+              storage::group parent = {})
+            const
+        {
+            return fields.store(settings, parent);
+        }
+
+
+        // Add one item for each setting to `cat`, in the order they were declared.
+        void
+        build(category& cat,
+              S& settings)
+            const
+        {
+            build(cat, settings, std::index_sequence_for<Ts...>{});
+        }
+
+
+    private:
+
+        template<std::size_t... Is>
+        void
+        check_choices(S& settings,
+                      storage::group parent,
+                      std::vector<storage::field_error>& errors,
+                      std::index_sequence<Is...>)
+            const
+        {
+            (check_choice(settings, parent, errors,
+                          fields.template get<Is>(), std::get<Is>(items)), ...);
+        }
+
+
+        template<typename T>
+        static
+        void
+        check_choice(S& settings,
+                     storage::group parent,
+                     std::vector<storage::field_error>& errors,
+                     const storage::field<S, T>& f,
+                     const item_entry<T>& entry)
+        {
+            if constexpr (std::is_enum_v<T>) {
+                auto& variable = settings.*f.member;
+                if (utils::index_of(entry.options.choices, variable))
+                    return;
+                // The schema loads enums by value; a value that's not one of the choices
+                // is replaced by the default, and stored.
+                auto res = storage::try_load_or_init_choice(f.k, variable, f.default_value,
+                                                            entry.options.choices,
+                                                            storage::choice_format::value,
+                                                            parent);
+                if (!res) {
+                    variable = f.default_value;
+                    errors.emplace_back(f.k.name(), std::move(res.error()));
+                }
+            }
+        }
+
+
+        template<std::size_t... Is>
+        void
+        build(category& cat,
+              S& settings,
+              std::index_sequence<Is...>)
+            const
+        {
+            (add_item(cat, settings, fields.template get<Is>(), std::get<Is>(items)), ...);
+        }
+
+
+        template<typename T>
+        static
+        void
+        add_item(category& cat,
+                 S& settings,
+                 const storage::field<S, T>& f,
+                 const item_entry<T>& entry)
+        {
+            if constexpr (std::is_enum_v<T>)
+                cat.add(choice_item<T>::create(std::string{entry.label},
+                                               settings.*f.member,
+                                               f.default_value,
+                                               entry.options.choices,
+                                               entry.options.page_size));
+            else
+                cat.add(detail::make_item<T>(std::string{entry.label},
+                                             settings.*f.member,
+                                             f.default_value,
+                                             entry.options));
+        }
+
+    };
+
+    template<typename S,
+             typename... Ts>
+    menu_schema(setting<S, Ts>...) -> menu_schema<S, Ts...>;
+
+} // namespace wups::config
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_MONITOR_ITEM_HPP
+#define WUPSXX_MONITOR_ITEM_HPP
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "item.hpp"
+#include "number_format.hpp"
+
+
+namespace wups::config {
+
+    struct monitor_options {
+        using time_source = std::chrono::steady_clock::time_point (*)() noexcept;
+
+        std::chrono::milliseconds interval{500}; // time between calls to the getter
+        time_source now = std::chrono::steady_clock::now;
+    };
+
+
+    // Read-only live value, like a counter updated by the plugin. WUPS asks for the display
+    // on every frame, but the getter is only called once per interval; in between, the
+    // last value is shown.
+    //
+    // The getter runs on the menu thread, and must not block: when the data is guarded by
+    // a mutex, use try_lock() and return false if it fails, to keep showing the previous
+    // value. Counters published through a lock-free std::atomic can be shown directly:
+    //
+    //     std::atomic<unsigned> fired;
+    //     wups::config::monitor_item::create("Combos fired", fired);
+
+    class monitor_item : public item {
+
+    public:
+
+        // Write the current value into `buf`; return false to keep the previous one.
+        using getter_type = std::function<bool(char* buf, std::size_t size)>;
+
+        using options = monitor_options;
+
+    private:
+
+        getter_type getter;
+        options opts;
+        mutable char value[80] = "...";
+        mutable std::chrono::steady_clock::time_point last_sample;
+        mutable bool sampled = false;
+
+    public:
+
+        monitor_item(const std::string& label,
+                     getter_type getter,
+                     const options& opts = {});
+
+        static
+        std::unique_ptr<monitor_item>
+        create(const std::string& label,
+               getter_type getter,
+               const options& opts = {});
+
+
+        template<typename T>
+            requires ((std::integral<T> || std::floating_point<T>)
+                      && std::atomic<T>::is_always_lock_free)
+        static
+        std::unique_ptr<monitor_item>
+        create(const std::string& label,
+               const std::atomic<T>& source,
+               const utils::number_format& format = {},
+               const options& opts = {})
+        {
+            // Note: `source` must outlive the item.
+            return create(label,
+                          [&source, format](char* buf, std::size_t size) -> bool
+                          {
+                              T val = source.load(std::memory_order_relaxed);
+                              utils::format_number(buf, size, val, format);
+                              return true;
+                          },
+                          opts);
+        }
+
+
+        // Call the getter on the next frame, without waiting for the interval.
+        void refresh() noexcept;
+
+
+        virtual void get_display(char* buf, std::size_t size) const override;
+
+        virtual bool on_focus_request(bool new_focus) const override;
+
+    protected:
+
+        virtual bool is_display_outdated() const noexcept override;
+
+    private:
+
+        void sample() const;
+
+    };
+
+} // namespace wups::config
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_NUMBER_FORMAT_HPP
+#define WUPSXX_NUMBER_FORMAT_HPP
+
+#include <charconv>             // to_chars()
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>         // errc
+
+#include "duration.hpp"
+
+
+// Formatting of numbers straight into a C buffer, without touching the heap; this is
+// what config items use to render values on every frame:
+//
+//     wups::config::int_item::create("Volume", volume, 50, 0, 100, 10, 1,
+//                                    {.suffix = "%"});
+
+
+namespace wups::utils {
+
+    struct number_format {
+        char thousands_sep = '\0'; // '\0' means no grouping
+        int precision = -1;        // fixed digits after the point; -1 means shortest
+        std::string suffix;        // appended after the unit, if any
+    };
+
+
+    namespace detail {
+
+        // Copy `digits` into `buf`, grouping the integer part, followed by `unit` and the
+        // suffix. The result is truncated to fit, and always null-terminated.
+        std::size_t
+        finish_number(char* buf,
+                      std::size_t size,
+                      std::string_view digits,
+                      std::string_view unit,
+                      const number_format& fmt)
+            noexcept;
+
+
+        template<typename T>
+        std::string_view
+        to_chars(char* first,
+                 char* last,
+                 T value,
+                 const number_format& fmt)
+            noexcept
+        {
+            std::to_chars_result res;
+            if constexpr (std::floating_point<T>) {
+                if (fmt.precision >= 0) {
+                    res = std::to_chars(first, last, value,
+                                        std::chars_format::fixed, fmt.precision);
+                    if (res.ec == std::errc{})
+                        return {first, res.ptr};
+                }
+                // Too large for fixed notation, fall back to the shortest form.
+                res = std::to_chars(first, last, value);
+            } else
+                res = std::to_chars(first, last, value);
+            if (res.ec != std::errc{})
+                return "?";
+            return {first, res.ptr};
+        }
+
+    } // namespace detail
+
+
+    // Write `value` into `buf`, as a null-terminated string; returns its length.
+    template<typename T>
+        requires ((std::integral<T> && !std::same_as<T, bool>) || std::floating_point<T>)
+    std::size_t
+    format_number(char* buf,
+                  std::size_t size,
+                  T value,
+                  const number_format& fmt = {})
+        noexcept
+    {
+        char tmp[128];
+        auto digits = detail::to_chars(tmp, tmp + sizeof tmp, value, fmt);
+        return detail::finish_number(buf, size, digits, {}, fmt);
+    }
+
+
+    // Durations are written with the same unit symbols as to_string().
+    template<concepts::duration D>
+    std::size_t
+    format_number(char* buf,
+                  std::size_t size,
+                  D value,
+                  const number_format& fmt = {})
+        noexcept
+    {
+        char tmp[128];
+        auto digits = detail::to_chars(tmp, tmp + sizeof tmp, value.count(), fmt);
+        return detail::finish_number(buf, size, digits, unit_symbol<D>(), fmt);
+    }
+
+
+    // Write the fixed-point number `ticks / scale`, using only integer math.
+    // A negative precision means as many decimals as needed to be exact, if possible
+    // (2 for a scale of 4 or 100), otherwise 3.
+    std::size_t
+    format_fixed(char* buf,
+                 std::size_t size,
+                 std::int32_t ticks,
+                 std::int32_t scale,
+                 const number_format& fmt = {})
+        noexcept;
+
+} // namespace wups::utils
+
+#endif
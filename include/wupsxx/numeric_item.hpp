@@ -11,6 +11,7 @@
 
 #include <memory>
 
+#include "number_format.hpp"
 #include "var_item.hpp"
 
 
@@ -28,6 +29,7 @@ namespace wups::config {
         T max_value;
         T fast_increment;
         T slow_increment;
+        utils::number_format format;
 
     public:
 
@@ -35,7 +37,8 @@ namespace wups::config {
                      T& variable, T default_value,
                      T min_value, T max_value,
                      T fast_increment = T{10},
-                     T slow_increment = T{1});
+                     T slow_increment = T{1},
+                     const utils::number_format& format = {});
 
         static
         std::unique_ptr<numeric_item>
@@ -43,7 +46,8 @@ namespace wups::config {
                T& variable, T default_value,
                T min_value, T max_value,
                T fast_increment = T{10},
-               T slow_increment = T{1});
+               T slow_increment = T{1},
+               const utils::number_format& format = {});
 
 
         virtual void get_display(char* buf, std::size_t size) const override;
@@ -52,6 +56,11 @@ namespace wups::config {
 
         virtual focus_status on_input(const simple_pad_data& input) override;
 
+    protected:
+
+        // How values are written; the default uses `format`.
+        virtual void format_value(char* buf, std::size_t size, T value) const;
+
     };
 
 } // namespace wups::config
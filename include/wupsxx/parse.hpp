@@ -0,0 +1,58 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_PARSE_HPP
+#define WUPSXX_PARSE_HPP
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <string_view>
+
+
+// Parsers for the types that are stored as strings. They don't throw, and only allocate
+// when the result itself needs memory (like a path.)
+//
+// The specializations are declared next to each type.
+
+
+namespace wups::utils {
+
+    enum class parse_errc {
+        empty,
+        invalid_char,
+        invalid_length,
+        out_of_range,
+        inexact,
+        unknown_token,
+        unknown_unit,
+        mixed_devices,
+        mixed_extensions,
+    };
+
+
+    const char* message(parse_errc code) noexcept;
+
+
+    struct parse_error {
+        parse_errc code;
+        std::size_t pos = 0; // where in the input the problem was found
+    };
+
+
+    template<typename T>
+    std::expected<T, parse_error> parse(std::string_view str);
+
+
+    template<>
+    std::expected<std::filesystem::path, parse_error>
+    parse<std::filesystem::path>(std::string_view str);
+
+} // namespace wups::utils
+
+#endif
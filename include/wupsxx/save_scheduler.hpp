@@ -0,0 +1,89 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_SAVE_SCHEDULER_HPP
+#define WUPSXX_SAVE_SCHEDULER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "storage.hpp"
+#include "storage_error.hpp"
+
+
+namespace wups::storage {
+
+    // Calls save() from a background thread.
+    // All requests made within `delay` of each other are coalesced into a single save.
+    // The thread is only started on the first request, and stops on flush().
+    //
+    // The dirty cached<> values are copied by request(), on the calling thread; the
+    // background thread only stores the copies and saves, holding the storage lock.
+    // If the save fails, the copies are kept and stored again on the next save.
+    class save_scheduler {
+
+    public:
+
+        using result_type = std::expected<void, storage_error>;
+
+        // Note: the callback is called from the background thread.
+        using callback_type = std::function<void(const result_type& result)>;
+
+
+        save_scheduler(std::chrono::milliseconds delay = std::chrono::milliseconds{500},
+                       callback_type callback = {});
+
+        // Disallow moving, since the thread holds the `this` pointer.
+        save_scheduler(save_scheduler&&) = delete;
+
+        // Calls flush().
+        ~save_scheduler();
+
+
+        void set_callback(callback_type callback);
+
+        // Schedule a save; this never blocks on the storage.
+        // Call it from the thread that sets the cached<> values.
+        void request();
+
+        // Copy the dirty cached<> values like request(), save them immediately along
+        // with anything pending, wait for it, and stop the thread.
+        // Call this from your DEINITIALIZE_PLUGIN() hook.
+        void flush();
+
+
+    private:
+
+        // Note: call with `mutex` locked.
+        void start_worker();
+
+        void run(std::stop_token token);
+
+
+        std::chrono::milliseconds delay;
+        callback_type callback;
+
+        std::mutex mutex;
+        std::condition_variable_any cond;
+        bool pending = false;
+        std::vector<detail::store_snapshot> snapshots;
+        std::chrono::steady_clock::time_point deadline;
+
+        std::jthread worker;
+
+    };
+
+} // namespace wups::storage
+
+#endif
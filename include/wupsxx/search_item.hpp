@@ -0,0 +1,125 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_SEARCH_ITEM_HPP
+#define WUPSXX_SEARCH_ITEM_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "item.hpp"
+
+
+namespace wups::config {
+
+    // Search other items by their label, and edit the matches from here.
+    //
+    // WUPS can't hide items, so the results are shown by this item instead: type a query
+    // (▲/▼ to pick a character, A to add it, B to erase it, + or X to finish), then use ◀/▶
+    // to go through the matches, and A to edit one of them.
+    //
+    // The labels are indexed when the first search starts; every character typed only
+    // checks the items that matched before it.
+
+    class search_item : public item {
+
+    public:
+
+        enum class match_mode {
+            prefix,
+            substring,
+        };
+
+    private:
+
+        enum class state_t {
+            idle,
+            typing,
+            browsing,
+            editing,
+        };
+
+        struct entry {
+            std::string label;
+            item* target;
+        };
+
+        match_mode mode;
+        std::vector<entry> entries;
+        bool indexed = false;
+
+        std::string query;
+        // The matches for every prefix of the query; the first one has all the entries.
+        std::vector<std::vector<std::uint32_t>> history;
+        std::string alphabet; // characters that can extend the current matches
+        std::size_t candidate = 0;
+        std::size_t current = 0;
+        state_t state = state_t::idle;
+
+    public:
+
+        search_item(const std::string& label,
+                    match_mode mode = match_mode::substring);
+
+        static
+        std::unique_ptr<search_item>
+        create(const std::string& label,
+               match_mode mode = match_mode::substring);
+
+
+        // Note: `target` must outlive this item, so add it to a category too.
+        // Items don't keep their labels, so give the label again here.
+        void add_target(item& target, const std::string& label);
+
+        const std::string& get_query() const noexcept;
+
+        std::size_t get_num_matches() const noexcept;
+
+
+        virtual void get_display(char* buf, std::size_t size) const override;
+
+        virtual void get_focused_display(char* buf, std::size_t size) const override;
+
+        virtual void on_focus_changed() override;
+
+        // Clears the query.
+        virtual void restore_default() override;
+
+        virtual void on_close() override;
+
+        virtual focus_status on_input(const simple_pad_data& input) override;
+
+        virtual focus_status on_input(const complex_pad_data& input) override;
+
+    private:
+
+        void build_index();
+
+        const std::vector<std::uint32_t>& matches() const noexcept;
+
+        const entry* current_match() const noexcept;
+
+        item* current_target() const noexcept;
+
+        void push_char(char c);
+
+        void pop_char();
+
+        void update_alphabet();
+
+        focus_status on_editing_input(const simple_pad_data& input);
+
+        focus_status on_editing_input(const complex_pad_data& input);
+
+    };
+
+} // namespace wups::config
+
+#endif
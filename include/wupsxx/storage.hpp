@@ -9,141 +9,264 @@
 #ifndef WUPSXX_STORAGE_HPP
 #define WUPSXX_STORAGE_HPP
 
+#include <concepts>
 #include <expected>
-#include <filesystem>
+#include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <wups/storage.h>
 
-#include "button_combo.hpp"
-#include "color.hpp"
-#include "duration.hpp"
 #include "storage_error.hpp"
+#include "storage_group.hpp"
+#include "storage_key.hpp"
 
 
 namespace wups::storage {
 
-    template<typename T>
-    std::expected<T, storage_error>
-    load(const std::string& key)
-    {
-        T value;
-        auto status = WUPSStorageAPI::Get(key,
-                                          value,
-                                          WUPSStorageAPI::GetOptions::RESIZE_EXISTING_BUFFER);
-        if (status != WUPS_STORAGE_ERROR_SUCCESS)
-            return std::unexpected{storage_error{"error loading key \"" + key + "\"",
-                                                 status}};
-        return value;
-    }
+    // These operate on the root group.
 
 
-    template<concepts::duration T>
+    template<typename T>
     std::expected<T, storage_error>
-    load(const std::string& key)
+    load(const key& k)
     {
-        auto value = load<int>(key);
-        if (!value)
-            return std::unexpected{value.error()};
-        return T{*value};
+        return group{}.load<T>(k);
     }
 
 
-    template<>
-    std::expected<utils::color, storage_error>
-    load<utils::color>(const std::string& key);
-
-
-    template<>
-    std::expected<std::filesystem::path, storage_error>
-    load<std::filesystem::path>(const std::string& key);
-
-
-    template<>
-    std::expected<utils::button_combo, storage_error>
-    load<utils::button_combo>(const std::string& key);
-
+    // The try_*() functions report errors through the return value; the others throw
+    // them as storage_error.
 
 
     template<typename T>
-    void
-    store(const std::string& key, const T& value)
+    std::expected<void, storage_error>
+    try_store(const key& k, const T& value)
     {
-        auto status = WUPSStorageAPI::Store(key, value);
-        if (status != WUPS_STORAGE_ERROR_SUCCESS)
-            throw storage_error{"error storing key \"" + key + "\"",
-                                status};
+        return group{}.try_store(k, value);
     }
 
 
-    template<concepts::duration T>
+    template<typename T>
     void
-    store(const std::string& key, const T& value)
+    store(const key& k, const T& value)
     {
-        store<int>(key, value.count());
+        group{}.store(k, value);
     }
 
 
-    void
-    store(const std::string& key, const utils::color& c);
-
-
-    void
-    store(const std::string& key, const std::filesystem::path& p);
-
-
-    void
-    store(const std::string& key, const utils::button_combo& bc);
-
-
-
     // This will either load the variable from the config, or initialize
     // it (and the config) with the default value.
+    template<typename T,
+             typename U>
+    std::expected<void, storage_error>
+    try_load_or_init(const key& k,
+                     T& variable,
+                     U&& init)
+    {
+        return group{}.try_load_or_init(k, variable, std::forward<U>(init));
+    }
+
+
     template<typename T,
              typename U>
     void
-    load_or_init(const std::string& key,
+    load_or_init(const key& k,
                  T& variable,
                  U&& init)
     {
-        auto status = load<T>(key);
-        if (status)
-            variable = std::move(*status);
-        else {
-            if (status.error().code != WUPS_STORAGE_ERROR_NOT_FOUND)
-                throw status.error();
-            variable = std::forward<U>(init);
-            store(key, variable);
-        }
+        group{}.load_or_init(k, variable, std::forward<U>(init));
     }
 
 
     // same as above, but ensure storage is in string format
+    template<typename T,
+             typename U>
+    std::expected<void, storage_error>
+    try_load_or_init_str(const key& k,
+                         T& variable,
+                         U&& init,
+                         const std::string& init_str)
+    {
+        return group{}.try_load_or_init_str(k, variable, std::forward<U>(init), init_str);
+    }
+
+
     template<typename T,
              typename U>
     void
-    load_or_init_str(const std::string& key,
+    load_or_init_str(const key& k,
                      T& variable,
                      U&& init,
                      const std::string& init_str)
     {
-        auto status = load<std::string>(key);
-        if (status)
-            variable = T{std::move(*status)};
-        else {
-            if (status.error().code != WUPS_STORAGE_ERROR_NOT_FOUND)
-                throw status.error();
-            variable = std::forward<U>(init);
-            store(key, init_str);
-        }
+        group{}.load_or_init_str(k, variable, std::forward<U>(init), init_str);
     }
 
 
+    // Flush all dirty cached<> entries, then save the storage.
+    std::expected<void, storage_error> try_save();
+
     void save();
 
+
+    // Reload the storage, and drop all values from cached<> entries and group handles.
+    std::expected<void, storage_error> try_reload();
+
     void reload();
 
+
+    namespace detail {
+
+        // A copy of a dirty value, that stores it when called.
+        using store_snapshot = std::function<std::expected<void, storage_error>()>;
+
+
+        // Type-erased base for cached<>, so save() and reload() can reach every entry.
+        class cache_entry {
+
+            std::string name;
+
+        protected:
+
+            // Note: refers to `name`, so it's resolved only once.
+            const storage::key key;
+            storage::group parent;
+            bool loaded = false;
+            bool dirty = false;
+
+        public:
+
+            cache_entry(const group& parent, const std::string& name);
+
+            // Disallow copying and moving, since the entry registers its `this` pointer.
+            cache_entry(const cache_entry&) = delete;
+
+            virtual ~cache_entry();
+
+            // Store the value, if it was changed since the last flush.
+            virtual std::expected<void, storage_error> try_flush() = 0;
+
+            void flush();
+
+            // Copy the value, if it was changed since the last flush, and consider it
+            // flushed; returns an empty function otherwise.
+            virtual store_snapshot take_snapshot() = 0;
+
+            // Forget the value, so it's loaded again on the next access.
+            void invalidate() noexcept;
+
+        };
+
+
+        // Copy the values of all dirty cached<> entries; used by save_scheduler, so
+        // only the calling thread touches the entries.
+        std::vector<store_snapshot> take_snapshots();
+
+        // Store the snapshots, then save the storage.
+        std::expected<void, storage_error>
+        try_save_snapshots(const std::vector<store_snapshot>& snapshots);
+
+    } // namespace detail
+
+
+    // A value kept decoded in memory, in front of the storage.
+    // The key is only loaded on the first access; `set()` only marks the entry as dirty,
+    // the value is written back on the next save().
+    // Note: entries are not synchronized, so only use them from one thread at a time.
+    template<typename T>
+    class cached : public detail::cache_entry {
+
+        T value;
+        const T default_value;
+
+    public:
+
+        cached(const std::string& name,
+               const T& default_value) :
+            cached{group{}, name, default_value}
+        {}
+
+
+        cached(const group& parent,
+               const std::string& name,
+               const T& default_value) :
+            cache_entry{parent, name},
+            value(default_value),
+            default_value(default_value)
+        {}
+
+
+        const T&
+        get()
+        {
+            if (!loaded) {
+                auto res = parent.load<T>(key);
+                if (res)
+                    value = std::move(*res);
+                else {
+                    if (res.error().code != WUPS_STORAGE_ERROR_NOT_FOUND)
+                        detail::raise(res.error());
+                    // Not in storage yet, so the default must be written back.
+                    value = default_value;
+                    dirty = true;
+                }
+                loaded = true;
+            }
+            return value;
+        }
+
+
+        void
+        set(const T& new_value)
+        {
+            if constexpr (std::equality_comparable<T>)
+                if (loaded && value == new_value)
+                    return;
+            value = new_value;
+            loaded = true;
+            dirty = true;
+        }
+
+
+        void
+        reset()
+        {
+            set(default_value);
+        }
+
+
+        virtual
+        std::expected<void, storage_error>
+        try_flush()
+            override
+        {
+            if (!dirty)
+                return {};
+            auto res = parent.try_store(key, value);
+            if (res)
+                dirty = false;
+            return res;
+        }
+
+
+        virtual
+        detail::store_snapshot
+        take_snapshot()
+            override
+        {
+            if (!dirty)
+                return {};
+            dirty = false;
+            return [parent = parent, name = std::string{key.name()}, value = value]
+            {
+                return group{parent}.try_store(storage::key{name}, value);
+            };
+        }
+
+    };
+
 } // namespace wups::storage
 
 #endif
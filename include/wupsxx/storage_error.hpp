@@ -25,6 +25,15 @@ namespace wups::storage {
 
     };
 
+
+    namespace detail {
+
+        // Throw `e`. When built without exceptions, log it and abort instead.
+        [[noreturn]]
+        void raise(const storage_error& e);
+
+    } // namespace detail
+
 } // namespace wups::storage
 
 #endif
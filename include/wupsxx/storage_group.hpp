@@ -0,0 +1,472 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_GROUP_HPP
+#define WUPSXX_STORAGE_GROUP_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>              // memcpy()
+#include <expected>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <wups/storage.h>
+
+#include "button_combo.hpp"
+#include "color.hpp"
+#include "duration.hpp"
+#include "storage_error.hpp"
+#include "storage_key.hpp"
+
+
+namespace wups::concepts {
+
+    namespace detail {
+
+        template<typename T>
+        struct is_blob : std::false_type {};
+
+        // Note: std::vector<std::uint8_t> is excluded, WUPS stores it natively.
+        template<typename T>
+            requires (std::is_trivially_copyable_v<T> && !std::same_as<T, std::uint8_t>)
+        struct is_blob<std::vector<T>> : std::true_type {};
+
+        template<typename T,
+                 std::size_t N>
+            requires std::is_trivially_copyable_v<T>
+        struct is_blob<std::array<T, N>> : std::true_type {};
+
+    } // namespace detail
+
+
+    // Containers that are stored as binary blobs.
+    template<typename T>
+    concept blob = detail::is_blob<T>::value;
+
+} // namespace wups::concepts
+
+
+namespace wups::storage {
+
+    class group;
+
+    // Defined in storage_observer.hpp.
+    void notify(const group& parent, const key& k);
+
+
+    // The layout version stored in the header of blobs with elements of type `T`.
+    // Specialize this when changing the layout of a struct, so old blobs are rejected:
+    //
+    //     template<>
+    //     constexpr inline std::uint32_t wups::storage::blob_version<my_entry> = 2;
+    template<typename T>
+    constexpr inline std::uint32_t blob_version = 0;
+
+
+    namespace detail {
+
+        // Build the error messages out of line, so the templates below stay small.
+        // A missing key gets a shared error without the key name, since it's expected.
+
+        storage_error
+        make_load_error(const key& k, WUPSStorageError status);
+
+        storage_error
+        make_store_error(const key& k, WUPSStorageError status);
+
+        storage_error
+        make_remove_error(const key& k, WUPSStorageError status);
+
+
+        // Serializes all calls into the WUPS storage API, so save_scheduler can save from
+        // its thread while other threads load and store. Recursive, since the bulk
+        // operations are made of single loads and stores.
+        std::recursive_mutex& storage_mutex() noexcept;
+
+
+        struct group_node;
+
+        // Forget all group handles; they're resolved again on the next access.
+        void invalidate_groups() noexcept;
+
+
+        // Marks types that have no WUPS item type; storage::mirror ignores them.
+        constexpr WUPSStorageItemType no_item_type = ~WUPSStorageItemType{0};
+
+        // The WUPS item type used to store `T`.
+        template<typename T>
+        constexpr
+        WUPSStorageItemType
+        item_type_of()
+            noexcept
+        {
+            if constexpr (std::same_as<T, bool>)
+                return WUPS_STORAGE_ITEM_BOOL;
+            else if constexpr (std::same_as<T, float>)
+                return WUPS_STORAGE_ITEM_FLOAT;
+            else if constexpr (std::same_as<T, double>)
+                return WUPS_STORAGE_ITEM_DOUBLE;
+            else if constexpr (std::same_as<T, std::string>)
+                return WUPS_STORAGE_ITEM_STRING;
+            else if constexpr (std::same_as<T, std::vector<std::uint8_t>>)
+                return WUPS_STORAGE_ITEM_BINARY;
+            else if constexpr (std::is_enum_v<T> && sizeof(T) == 4)
+                return WUPS_STORAGE_ITEM_U32;
+            else if constexpr (std::integral<T> && sizeof(T) == 4)
+                return std::signed_integral<T> ? WUPS_STORAGE_ITEM_S32 : WUPS_STORAGE_ITEM_U32;
+            else if constexpr (std::integral<T> && sizeof(T) == 8)
+                return std::signed_integral<T> ? WUPS_STORAGE_ITEM_S64 : WUPS_STORAGE_ITEM_U64;
+            else
+                return no_item_type;
+        }
+
+
+        // Let storage::mirror know which keys exist, and which ones changed.
+        // These are cheap when no mirror is active.
+        void track_load(const group& parent, const key& k, WUPSStorageItemType type);
+        void track_store(const group& parent, const key& k, WUPSStorageItemType type);
+        void track_remove(const group& parent, const key& k);
+
+
+        // Let migrate() record the old value of a key before it's changed, so a failed
+        // migration can be undone; `type` is the type about to be stored, or
+        // no_item_type. This is cheap when no migration is running.
+        void journal_change(const group& parent,
+                            wups_storage_item handle,
+                            const key& k,
+                            WUPSStorageItemType type);
+
+
+        // Copy the bytes of an item, as the WUPS API sees them.
+        std::expected<std::vector<std::byte>, WUPSStorageError>
+        read_raw_item(wups_storage_item parent,
+                      const std::string& name,
+                      WUPSStorageItemType type);
+
+
+        // Feed storage::stats; these only check a flag while stats are disabled.
+        void count_load(WUPSStorageItemType type) noexcept;
+        void count_store(WUPSStorageItemType type, std::size_t bytes) noexcept;
+        void count_failure(WUPSStorageError status) noexcept;
+
+
+        template<typename T>
+        constexpr
+        std::size_t
+        stored_size(const T& value)
+            noexcept
+        {
+            if constexpr (requires { value.size(); })
+                return value.size() * sizeof(typename T::value_type);
+            else
+                return sizeof value;
+        }
+
+    } // namespace detail
+
+
+    // A WUPS sub-item, that holds its own keys.
+    // Opening the same group again reuses the same handle, so this is cheap to construct
+    // and to copy. The sub-item is only looked up on the first access, and again after a
+    // reload(); it's only created when something is stored in it, loading from a group
+    // that doesn't exist fails with WUPS_STORAGE_ERROR_NOT_FOUND.
+    class group {
+
+        detail::group_node* node = nullptr; // null means the root
+
+    public:
+
+        // The root group, where the top-level keys are.
+        constexpr
+        group()
+            noexcept = default;
+
+        group(const group& parent, const key& k);
+
+
+        group
+        open(const key& k)
+            const
+        {
+            return group{*this, k};
+        }
+
+
+        constexpr
+        bool
+        operator ==(const group& other) const noexcept = default;
+
+
+        // With `create`, a missing sub-item (and its parents) is created.
+        std::expected<wups_storage_item, storage_error>
+        get_handle(bool create = false)
+            const;
+
+
+        template<typename T>
+        std::expected<T, storage_error>
+        load(const key& k)
+            const
+        {
+            std::lock_guard guard{detail::storage_mutex()};
+            auto parent = get_handle();
+            if (!parent)
+                return std::unexpected{parent.error()};
+            T value;
+            auto status = WUPSStorageAPI::GetEx(*parent,
+                                                k.name(),
+                                                value,
+                                                WUPSStorageAPI::GetOptions::RESIZE_EXISTING_BUFFER);
+            if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                return std::unexpected{detail::make_load_error(k, status)};
+            detail::track_load(*this, k, detail::item_type_of<T>());
+            detail::count_load(detail::item_type_of<T>());
+            return value;
+        }
+
+
+        template<concepts::duration T>
+        std::expected<T, storage_error>
+        load(const key& k)
+            const
+        {
+            auto value = load<int>(k);
+            if (!value)
+                return std::unexpected{value.error()};
+            return T{*value};
+        }
+
+
+        template<concepts::blob T>
+        std::expected<T, storage_error>
+        load(const key& k)
+            const
+        {
+            using E = typename T::value_type;
+            auto bytes = load_bytes(k, blob_version<E>, sizeof(E));
+            if (!bytes)
+                return std::unexpected{bytes.error()};
+            T result;
+            if constexpr (requires { result.resize(0); })
+                result.resize(bytes->size() / sizeof(E));
+            else if (bytes->size() != sizeof result)
+                return std::unexpected{detail::make_load_error(k,
+                                                               WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE)};
+            if (!result.empty())
+                std::memcpy(result.data(), bytes->data(), result.size() * sizeof(E));
+            return result;
+        }
+
+
+        // Load a blob's payload, after checking its header.
+        std::expected<std::vector<std::byte>, storage_error>
+        load_bytes(const key& k,
+                   std::uint32_t version = 0,
+                   std::uint32_t element_size = 1)
+            const;
+
+
+        // The try_*() functions report errors through the return value; the others throw
+        // them as storage_error.
+
+
+        template<typename T>
+        std::expected<void, storage_error>
+        try_store(const key& k, const T& value)
+        {
+            std::unique_lock lock{detail::storage_mutex()};
+            auto parent = get_handle(true);
+            if (!parent)
+                return std::unexpected{parent.error()};
+            detail::journal_change(*this, *parent, k, detail::item_type_of<T>());
+            auto status = WUPSStorageAPI::StoreEx(*parent, k.name(), value);
+            if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                return std::unexpected{detail::make_store_error(k, status)};
+            detail::track_store(*this, k, detail::item_type_of<T>());
+            detail::count_store(detail::item_type_of<T>(), detail::stored_size(value));
+            // Note: notify outside the storage lock, so observers don't contend with it.
+            lock.unlock();
+            notify(*this, k);
+            return {};
+        }
+
+
+        template<concepts::duration T>
+        std::expected<void, storage_error>
+        try_store(const key& k, const T& value)
+        {
+            return try_store<int>(k, value.count());
+        }
+
+
+        std::expected<void, storage_error>
+        try_store(const key& k, const utils::color& c);
+
+
+        std::expected<void, storage_error>
+        try_store(const key& k, const std::filesystem::path& p);
+
+
+        std::expected<void, storage_error>
+        try_store(const key& k, const utils::button_combo& bc);
+
+
+        template<typename T>
+            requires concepts::blob<std::vector<T>>
+        std::expected<void, storage_error>
+        try_store(const key& k, const std::vector<T>& v)
+        {
+            return try_store_bytes(k, std::as_bytes(std::span{v}), blob_version<T>, sizeof(T));
+        }
+
+
+        template<typename T,
+                 std::size_t N>
+            requires concepts::blob<std::array<T, N>>
+        std::expected<void, storage_error>
+        try_store(const key& k, const std::array<T, N>& a)
+        {
+            return try_store_bytes(k, std::as_bytes(std::span{a}), blob_version<T>, sizeof(T));
+        }
+
+
+        // Load it back as std::vector<std::byte>.
+        std::expected<void, storage_error>
+        try_store(const key& k, std::span<const std::byte> data);
+
+
+        template<typename T>
+        void
+        store(const key& k, const T& value)
+        {
+            auto res = try_store(k, value);
+            if (!res)
+                detail::raise(res.error());
+        }
+
+
+        // Delete a key (or sub-item); does nothing if it doesn't exist.
+        std::expected<void, storage_error>
+        try_remove(const key& k);
+
+
+        void
+        remove(const key& k);
+
+
+        // Store a blob: a header with the size and layout version, followed by `data`.
+        std::expected<void, storage_error>
+        try_store_bytes(const key& k,
+                        std::span<const std::byte> data,
+                        std::uint32_t version = 0,
+                        std::uint32_t element_size = 1);
+
+
+        void
+        store_bytes(const key& k,
+                    std::span<const std::byte> data,
+                    std::uint32_t version = 0,
+                    std::uint32_t element_size = 1);
+
+
+        // This will either load the variable from the config, or initialize
+        // it (and the config) with the default value.
+        template<typename T,
+                 typename U>
+        std::expected<void, storage_error>
+        try_load_or_init(const key& k,
+                         T& variable,
+                         U&& init)
+        {
+            auto status = load<T>(k);
+            if (status) {
+                variable = std::move(*status);
+                return {};
+            }
+            if (status.error().code != WUPS_STORAGE_ERROR_NOT_FOUND)
+                return std::unexpected{std::move(status.error())};
+            variable = std::forward<U>(init);
+            return try_store(k, variable);
+        }
+
+
+        template<typename T,
+                 typename U>
+        void
+        load_or_init(const key& k,
+                     T& variable,
+                     U&& init)
+        {
+            auto res = try_load_or_init(k, variable, std::forward<U>(init));
+            if (!res)
+                detail::raise(res.error());
+        }
+
+
+        // same as above, but ensure storage is in string format
+        template<typename T,
+                 typename U>
+        std::expected<void, storage_error>
+        try_load_or_init_str(const key& k,
+                             T& variable,
+                             U&& init,
+                             const std::string& init_str)
+        {
+            auto status = load<std::string>(k);
+            if (status) {
+                variable = T{std::move(*status)};
+                return {};
+            }
+            if (status.error().code != WUPS_STORAGE_ERROR_NOT_FOUND)
+                return std::unexpected{std::move(status.error())};
+            variable = std::forward<U>(init);
+            return try_store(k, init_str);
+        }
+
+
+        template<typename T,
+                 typename U>
+        void
+        load_or_init_str(const key& k,
+                         T& variable,
+                         U&& init,
+                         const std::string& init_str)
+        {
+            auto res = try_load_or_init_str(k, variable, std::forward<U>(init), init_str);
+            if (!res)
+                detail::raise(res.error());
+        }
+
+    };
+
+
+    template<>
+    std::expected<utils::color, storage_error>
+    group::load<utils::color>(const key& k) const;
+
+
+    template<>
+    std::expected<std::filesystem::path, storage_error>
+    group::load<std::filesystem::path>(const key& k) const;
+
+
+    template<>
+    std::expected<utils::button_combo, storage_error>
+    group::load<utils::button_combo>(const key& k) const;
+
+} // namespace wups::storage
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_KEY_HPP
+#define WUPSXX_STORAGE_KEY_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+namespace wups::storage {
+
+    // FNV-1a, 32 bits.
+    constexpr
+    std::uint32_t
+    hash(std::string_view str)
+        noexcept
+    {
+        std::uint32_t h = 0x811c9dc5u;
+        for (char c : str) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 0x01000193u;
+        }
+        return h;
+    }
+
+
+    // A non-owning reference to a key name, with a precomputed hash.
+    // When constructed from a literal, it can be computed at compile time:
+    //
+    //     constexpr wups::storage::key speed_key{"speed"};
+    //
+    // Note: the name must be null-terminated, since WUPS passes it on as a C string.
+    class key {
+
+        std::string_view name_;
+        std::uint32_t hash_;
+
+    public:
+
+        constexpr
+        key(const char* name)
+            noexcept :
+            name_{name},
+            hash_{storage::hash(name_)}
+        {}
+
+
+        key(const std::string& name)
+            noexcept :
+            name_{name},
+            hash_{storage::hash(name_)}
+        {}
+
+
+        constexpr
+        std::string_view
+        name()
+            const noexcept
+        {
+            return name_;
+        }
+
+
+        constexpr
+        std::uint32_t
+        hash()
+            const noexcept
+        {
+            return hash_;
+        }
+
+
+        constexpr
+        bool
+        operator ==(const key& other)
+            const noexcept
+        {
+            return hash_ == other.hash_ && name_ == other.name_;
+        }
+
+    };
+
+} // namespace wups::storage
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_MIGRATION_HPP
+#define WUPSXX_STORAGE_MIGRATION_HPP
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <utility>
+
+#include "storage_error.hpp"
+#include "storage_group.hpp"
+#include "storage_key.hpp"
+
+
+// Migrations upgrade old storage when keys are renamed, or change type. The storage
+// holds a version number; each step upgrades it from `from` to `from + 1`:
+//
+//     const wups::storage::migration_step steps[] = {
+//         {0, [](wups::storage::group& g)
+//             {
+//                 return wups::storage::convert<int, std::chrono::seconds>(
+//                     g, "delay", "delay",
+//                     [](int ms) { return std::chrono::seconds{ms / 1000}; });
+//             }},
+//         {1, [](wups::storage::group& g) { return wups::storage::rename<int>(g, "spd", "speed"); }},
+//     };
+//
+//     auto res = wups::storage::migrate(2, steps);
+//
+// Call migrate() before loading anything else.
+
+
+namespace wups::storage {
+
+    using migration_result = std::expected<void, storage_error>;
+
+
+    struct migration_step {
+        std::uint32_t from;
+        std::function<migration_result(group& parent)> apply;
+    };
+
+
+    // Run all steps needed to reach `target` version, then save once.
+    // A storage without the version key is assumed to be at version 0.
+    // If any step, or the save, fails, the keys changed by the steps are put back the way
+    // they were; changes made outside migrate() are kept. Removed sub-groups, and
+    // sub-groups created by the steps, are not restored.
+    migration_result
+    migrate(std::uint32_t target,
+            std::span<const migration_step> steps,
+            group parent = {},
+            const key& version_key = "schema_version");
+
+
+    // Replace `old_key`, of type `From`, by `new_key`, of type `To`; the value is converted
+    // by `func`. Does nothing if `old_key` doesn't exist.
+    template<typename From,
+             typename To,
+             typename F>
+    migration_result
+    convert(group& parent,
+            const key& old_key,
+            const key& new_key,
+            F&& func)
+    {
+        auto old_value = parent.load<From>(old_key);
+        if (!old_value) {
+            if (old_value.error().code == WUPS_STORAGE_ERROR_NOT_FOUND)
+                return {};
+            return std::unexpected{std::move(old_value.error())};
+        }
+        if (!(old_key == new_key)) {
+            auto res = parent.try_remove(old_key);
+            if (!res)
+                return res;
+        }
+        return parent.try_store(new_key,
+                                To(std::invoke(std::forward<F>(func), std::move(*old_value))));
+    }
+
+
+    template<typename T>
+    migration_result
+    rename(group& parent,
+           const key& old_key,
+           const key& new_key)
+    {
+        return convert<T, T>(parent, old_key, new_key, [](T&& v) { return std::move(v); });
+    }
+
+} // namespace wups::storage
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_MIRROR_HPP
+#define WUPSXX_STORAGE_MIRROR_HPP
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+
+#include "storage_error.hpp"
+#include "storage_group.hpp"
+
+
+// A mirror keeps a checksummed copy of the keys in a group, in a separate file, so
+// settings survive a config file that got corrupted while it was being saved:
+//
+//     wups::storage::mirror settings_mirror{
+//         wups::storage::group{},
+//         "/vol/external01/wiiu/plugins/config/my_plugin.mirror"
+//     };
+//
+//     INITIALIZE_PLUGIN()
+//     {
+//         settings_mirror.verify(); // before loading any settings
+//         ...
+//     }
+//
+// The mirror learns the keys as they are loaded and stored through libwupsxx. After
+// every successful save(), the keys that changed are appended to the mirror file, as a
+// checksummed block; when the file grows to twice the size of a fresh copy, it's
+// replaced atomically by one. If updating the mirror fails, it's discarded, and not used
+// to restore anything until the next successful update.
+// reload() verifies the group against every mirror; if the config file can't be loaded
+// at all, the mirrored keys are written back from the mirrors. Keys that are not in any
+// mirror are not restored.
+//
+// Note: sub-groups are not included; use a separate mirror for each one.
+
+
+namespace wups::storage {
+
+    namespace detail {
+
+        struct mirror_state;
+
+        // Called by save().
+        std::expected<void, storage_error> update_mirrors();
+
+        // Called by reload(); returns how many keys were restored.
+        std::expected<std::size_t, storage_error> verify_mirrors();
+
+        // Called by reload() when the config file can't be loaded: write back the keys
+        // of every mirror that has a good copy; other keys are left as they are. Returns
+        // how many keys were restored.
+        std::expected<std::size_t, storage_error> restore_mirrors();
+
+    } // namespace detail
+
+
+    class mirror {
+
+        std::unique_ptr<detail::mirror_state> st;
+
+    public:
+
+        mirror(const group& primary, const std::filesystem::path& filename);
+
+        // Disallow copying and moving, since the mirror registers its `this` pointer.
+        mirror(const mirror&) = delete;
+
+        ~mirror();
+
+
+        // Compare the group against the last good copy, and restore the keys that don't
+        // match. Returns how many keys were restored; call save() if it's not zero.
+        // Does nothing while the mirror is discarded.
+        std::expected<std::size_t, storage_error>
+        verify();
+
+
+        // Copy the keys that changed since the last update into the mirror file.
+        // This is called by save().
+        std::expected<void, storage_error>
+        update();
+
+    };
+
+} // namespace wups::storage
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_OBSERVER_HPP
+#define WUPSXX_STORAGE_OBSERVER_HPP
+
+#include <cstdint>
+#include <functional>
+
+#include "storage_group.hpp"
+#include "storage_key.hpp"
+
+
+// Observers are notified when a setting changes, either because it was stored, or
+// because a config item committed a new value to its variable.
+//
+// Notifications are delivered from a background thread, so observers can do slow work
+// without stalling the config menu. Multiple changes that happen before the observer
+// runs are coalesced into a single call.
+
+
+namespace wups::storage {
+
+    using observer = std::function<void()>;
+
+
+    // Unregisters the observer when destroyed; if it's being called right now, waits for
+    // it to return.
+    class subscription {
+
+        std::uint64_t id = 0;
+
+    public:
+
+        constexpr
+        subscription()
+            noexcept = default;
+
+        explicit
+        subscription(std::uint64_t id)
+            noexcept;
+
+        subscription(subscription&& other) noexcept;
+
+        ~subscription();
+
+        subscription& operator =(subscription&& other) noexcept;
+
+        void reset() noexcept;
+
+    };
+
+
+    // Call `obs` when `k` is stored in `parent`.
+    [[nodiscard]]
+    subscription
+    observe(const group& parent, const key& k, observer obs);
+
+    // Call `obs` when `k` is stored in the root group.
+    [[nodiscard]]
+    subscription
+    observe(const key& k, observer obs);
+
+
+    [[nodiscard]]
+    subscription
+    observe_address(const void* address, observer obs);
+
+    // Call `obs` when a config item commits a change to `variable`.
+    template<typename T>
+    [[nodiscard]]
+    subscription
+    observe_variable(const T& variable, observer obs)
+    {
+        return observe_address(&variable, std::move(obs));
+    }
+
+
+    void notify(const group& parent, const key& k);
+
+    void notify_address(const void* address);
+
+    template<typename T>
+    void
+    notify_variable(const T& variable)
+    {
+        notify_address(&variable);
+    }
+
+
+    // Deliver all pending notifications, wait for them, and stop the thread.
+    // Call this from your DEINITIALIZE_PLUGIN() hook.
+    void flush_notifications();
+
+} // namespace wups::storage
+
+#endif
@@ -0,0 +1,232 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_SCHEMA_HPP
+#define WUPSXX_STORAGE_SCHEMA_HPP
+
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "storage_error.hpp"
+#include "storage_group.hpp"
+#include "storage_key.hpp"
+
+
+// A schema describes all the settings in a struct, so they can be loaded and stored
+// together:
+//
+//     struct settings {
+//         bool enabled;
+//         std::chrono::milliseconds delay;
+//         wups::utils::color color;
+//     };
+//
+//     const wups::storage::schema settings_schema{
+//         wups::storage::field{"enabled", &settings::enabled, true},
+//         wups::storage::field{"delay",   &settings::delay,   100ms},
+//         wups::storage::field{"color",   &settings::color,   wups::utils::color{0xff, 0, 0}},
+//     };
+
+
+namespace wups::storage {
+
+    template<typename S,
+             typename T>
+    struct field {
+
+        key k;
+        T S::* member;
+        T default_value;
+
+
+        template<typename U>
+        constexpr
+        field(const key& k,
+              T S::* member,
+              U&& default_value) :
+            k{k},
+            member{member},
+            default_value(std::forward<U>(default_value))
+        {}
+
+    };
+
+    template<typename S,
+             typename T,
+             typename U>
+    field(const key&, T S::*, U&&) -> field<S, T>;
+
+
+    struct field_error {
+        std::string_view key;
+        storage_error error;
+    };
+
+
+    using schema_result = std::expected<void, std::vector<field_error>>;
+
+
+    template<typename S,
+             typename... Ts>
+    class schema {
+
+        std::tuple<field<S, Ts>...> fields;
+
+    public:
+
+        constexpr
+        schema(field<S, Ts>... fields) :
+            fields{std::move(fields)...}
+        {}
+
+
+        static constexpr
+        std::size_t
+        size()
+            noexcept
+        {
+            return sizeof...(Ts);
+        }
+
+
+        // Set every member to its default value.
+        void
+        reset(S& settings)
+            const
+        {
+            std::apply([&settings](const auto&... f)
+            {
+                ((settings.*f.member = f.default_value), ...);
+            },
+                fields);
+        }
+
+
+        // Load all members in one pass. Members that are not found, or fail to load, are
+        // set to their default value. The defaults for the missing keys are then stored
+        // in one batch.
+        // Every key that failed is reported, instead of stopping at the first error.
+        schema_result
+        load(S& settings,
+             group parent = {})
+            const
+        {
+            std::vector<field_error> errors;
+            std::array<bool, size()> missing{};
+
+            std::size_t idx = 0;
+            std::apply([&](const auto&... f)
+            {
+                (load_field(parent, f, settings, missing[idx++], errors), ...);
+            },
+                fields);
+
+            idx = 0;
+            std::apply([&](const auto&... f)
+            {
+                ((missing[idx++] ? store_field(parent, f, settings, errors) : void()), ...);
+            },
+                fields);
+
+            if (!errors.empty())
+                return std::unexpected{std::move(errors)};
+            return {};
+        }
+
+
+        // Store all members; every key that failed is reported.
+        schema_result
+        store(const S& settings,
+              group parent = {})
+            const
+        {
+            std::vector<field_error> errors;
+            std::apply([&](const auto&... f)
+            {
+                (store_field(parent, f, settings, errors), ...);
+            },
+                fields);
+
+            if (!errors.empty())
+                return std::unexpected{std::move(errors)};
+            return {};
+        }
+
+
+        template<std::size_t I>
+        constexpr
+        const auto&
+        get()
+            const noexcept
+        {
+            return std::get<I>(fields);
+        }
+
+
+        // Call `func(field)` for each field.
+        template<typename F>
+        void
+        for_each(F&& func)
+            const
+        {
+            std::apply([&func](const auto&... f) { (func(f), ...); },
+                       fields);
+        }
+
+
+    private:
+
+        template<typename T>
+        static
+        void
+        load_field(const group& parent,
+                   const field<S, T>& f,
+                   S& settings,
+                   bool& missing,
+                   std::vector<field_error>& errors)
+        {
+            auto res = parent.load<T>(f.k);
+            if (res) {
+                settings.*f.member = std::move(*res);
+                return;
+            }
+            settings.*f.member = f.default_value;
+            if (res.error().code == WUPS_STORAGE_ERROR_NOT_FOUND)
+                missing = true;
+            else
+                errors.emplace_back(f.k.name(), std::move(res.error()));
+        }
+
+
+        template<typename T>
+        static
+        void
+        store_field(group parent,
+                    const field<S, T>& f,
+                    const S& settings,
+                    std::vector<field_error>& errors)
+        {
+            auto res = parent.try_store(f.k, settings.*f.member);
+            if (!res)
+                errors.emplace_back(f.k.name(), std::move(res.error()));
+        }
+
+    };
+
+    template<typename S,
+             typename... Ts>
+    schema(field<S, Ts>...) -> schema<S, Ts...>;
+
+} // namespace wups::storage
+
+#endif
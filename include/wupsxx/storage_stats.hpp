@@ -0,0 +1,146 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_STATS_HPP
+#define WUPSXX_STORAGE_STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <wups/storage.h>
+
+
+// Counters for the storage I/O done through libwupsxx. They're disabled by default, and
+// cost a single atomic load per operation while disabled:
+//
+//     wups::storage::stats::enable();
+//     ...
+//     auto s = wups::storage::stats::get();
+//     logger::printf("%u saves, %u us max\n", s.save.count, s.save.max.count());
+//
+// See also config::storage_stats_item, to show them in the config menu.
+
+
+namespace wups::storage::stats {
+
+    // Loads and stores of types that have no WUPS item type go into the last slot.
+    constexpr std::size_t num_item_types = WUPS_STORAGE_ITEM_DOUBLE + 1;
+
+
+    struct timing {
+
+        static constexpr std::size_t num_buckets = 12;
+
+        std::uint32_t count = 0;
+        std::chrono::microseconds total{0};
+        std::chrono::microseconds min = std::chrono::microseconds::max();
+        std::chrono::microseconds max{0};
+        // histogram[i] counts the durations below bucket_limit(i), but not below the
+        // previous limit; the last bucket has everything else.
+        std::array<std::uint32_t, num_buckets> histogram{};
+
+
+        static
+        constexpr
+        std::chrono::milliseconds
+        bucket_limit(std::size_t i)
+            noexcept
+        {
+            return std::chrono::milliseconds{1u << i};
+        }
+
+
+        std::chrono::microseconds
+        mean()
+            const noexcept;
+
+
+        void
+        add(std::chrono::microseconds d)
+            noexcept;
+
+    };
+
+
+    // Failures are counted separately for each of these; the rest share one slot.
+    constexpr std::array known_errors{
+        WUPS_STORAGE_ERROR_INVALID_ARGUMENT,
+        WUPS_STORAGE_ERROR_MALLOC_FAILED,
+        WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE,
+        WUPS_STORAGE_ERROR_BUFFER_TOO_SMALL,
+        WUPS_STORAGE_ERROR_ALREADY_EXISTS,
+        WUPS_STORAGE_ERROR_IO_ERROR,
+        WUPS_STORAGE_ERROR_NOT_FOUND,
+        WUPS_STORAGE_ERROR_INTERNAL_NOT_INITIALIZED,
+        WUPS_STORAGE_ERROR_INTERNAL_INVALID_VERSION,
+        WUPS_STORAGE_ERROR_UNKNOWN_ERROR,
+    };
+
+
+    struct snapshot {
+
+        static constexpr std::size_t num_error_slots = known_errors.size() + 1;
+
+        // Successful operations, indexed by WUPSStorageItemType.
+        std::array<std::uint32_t, num_item_types + 1> loads{};
+        std::array<std::uint32_t, num_item_types + 1> stores{};
+        std::uint64_t bytes_written = 0;
+
+        timing save;
+        timing reload;
+
+        // Failed operations, by error; values that can't be parsed count as
+        // WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE. Loading a missing key is not a failure.
+        std::array<std::uint32_t, num_error_slots> failures{};
+
+
+        std::uint32_t
+        total_loads()
+            const noexcept;
+
+
+        std::uint32_t
+        total_stores()
+            const noexcept;
+
+
+        std::uint32_t
+        failures_of(WUPSStorageError status)
+            const noexcept;
+
+
+        std::uint32_t
+        total_failures()
+            const noexcept;
+
+    };
+
+
+    void enable(bool on = true) noexcept;
+
+    bool enabled() noexcept;
+
+    snapshot get();
+
+    // Zero all counters; this does not change enabled().
+    void reset() noexcept;
+
+} // namespace wups::storage::stats
+
+
+namespace wups::storage::detail {
+
+    // Called by save() and reload(), only when stats are enabled.
+    void count_save(std::chrono::microseconds d) noexcept;
+    void count_reload(std::chrono::microseconds d) noexcept;
+
+} // namespace wups::storage::detail
+
+#endif
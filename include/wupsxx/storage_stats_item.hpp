@@ -0,0 +1,42 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_STATS_ITEM_HPP
+#define WUPSXX_STORAGE_STATS_ITEM_HPP
+
+#include <memory>
+
+#include "item.hpp"
+
+
+namespace wups::config {
+
+    // Shows storage::stats, read-only. When focused, ◀/▶ go through the pages: totals,
+    // loads and stores per type, save and reload timings, and failures.
+    struct storage_stats_item : item {
+
+        unsigned page = 0;
+
+        storage_stats_item(const std::string& label);
+
+        static
+        std::unique_ptr<storage_stats_item>
+        create(const std::string& label);
+
+
+        virtual void get_display(char* buf, std::size_t size) const override;
+
+        virtual void get_focused_display(char* buf, std::size_t size) const override;
+
+        virtual focus_status on_input(const simple_pad_data& input) override;
+
+    };
+
+} // namespace wups::config
+
+#endif
@@ -0,0 +1,354 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WUPSXX_STORAGE_TRANSACTION_HPP
+#define WUPSXX_STORAGE_TRANSACTION_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <wups/storage.h>
+
+#include "storage_error.hpp"
+#include "storage_group.hpp"
+#include "storage_key.hpp"
+#include "storage_schema.hpp"
+
+
+// A transaction stages stores in memory, and writes them all at once on commit():
+//
+//     wups::storage::transaction tx;
+//     tx.load_or_init("enabled", enabled, true);
+//     tx.load_or_init("delay", delay, 100ms);
+//     tx.commit();
+//
+// If anything throws before commit(), the destructor restores the variables that were
+// assigned through the transaction, and nothing is written. If commit() fails partway,
+// by returning an error or by throwing, it's rolled back the same way.
+
+
+namespace wups::storage {
+
+    namespace detail {
+
+        // The type a staged value is kept as: string literals and C strings become
+        // std::string, so they don't dangle.
+        template<typename U>
+        using staged_type_t = std::conditional_t<
+            std::is_convertible_v<std::decay_t<U>, const char*>,
+            std::string,
+            std::decay_t<U>>;
+
+
+        // A store waiting for commit().
+        class staged_store {
+
+        public:
+
+            group parent;
+            const std::string name;
+
+        protected:
+
+            // Set once the value was actually written.
+            bool written = false;
+
+        public:
+
+            staged_store(const group& parent, const key& k);
+
+            virtual ~staged_store();
+
+            // Write the value, unless the storage already has it.
+            virtual std::expected<void, storage_error> commit() = 0;
+
+            // Put back what the storage had before commit(); this is best-effort.
+            // Note: storing can throw (e.g. std::bad_alloc), rollback() catches it.
+            virtual void undo() = 0;
+
+        };
+
+
+        // The old value of a variable assigned through a transaction.
+        class variable_backup {
+
+        public:
+
+            const void* const address;
+
+            explicit variable_backup(const void* address) noexcept;
+
+            virtual ~variable_backup();
+
+            virtual void restore() noexcept = 0;
+
+        };
+
+
+        template<typename T>
+        class staged_store_for : public staged_store {
+
+            T value;
+            // What the storage had before commit(); empty if the key didn't exist.
+            std::optional<T> previous;
+            bool previous_known = false;
+
+        public:
+
+            template<typename U>
+            staged_store_for(const group& parent,
+                             const key& k,
+                             U&& value) :
+                staged_store{parent, k},
+                value(std::forward<U>(value))
+            {}
+
+
+            virtual
+            std::expected<void, storage_error>
+            commit()
+                override
+            {
+                const key k{name};
+                auto current = parent.load<T>(k);
+                if (current) {
+                    if constexpr (std::equality_comparable<T>)
+                        if (*current == value)
+                            return {};
+                    previous = std::move(*current);
+                    previous_known = true;
+                } else if (current.error().code == WUPS_STORAGE_ERROR_NOT_FOUND)
+                    previous_known = true;
+                auto res = parent.try_store(k, value);
+                if (res)
+                    written = true;
+                return res;
+            }
+
+
+            virtual
+            void
+            undo()
+                override
+            {
+                if (!written || !previous_known)
+                    return;
+                // Errors are ignored, the original error is more relevant.
+                const key k{name};
+                if (previous)
+                    (void) parent.try_store(k, *previous);
+                else
+                    (void) parent.try_remove(k);
+            }
+
+        };
+
+
+        template<typename T>
+        class variable_backup_for : public variable_backup {
+
+            T& variable;
+            T old_value;
+
+        public:
+
+            explicit
+            variable_backup_for(T& variable) :
+                variable_backup{&variable},
+                variable(variable),
+                old_value(variable)
+            {}
+
+
+            virtual
+            void
+            restore()
+                noexcept override
+            {
+                variable = std::move(old_value);
+            }
+
+        };
+
+    } // namespace detail
+
+
+    // Not thread-safe: use one transaction per thread.
+    class transaction {
+
+        std::vector<std::unique_ptr<detail::staged_store>> stores;
+        std::vector<std::unique_ptr<detail::variable_backup>> backups;
+
+    public:
+
+        transaction() noexcept = default;
+
+        // Disallow copying and moving, the staged stores refer to the caller's variables.
+        transaction(const transaction&) = delete;
+
+        // Roll back anything that was not committed.
+        ~transaction();
+
+
+        // Number of stores waiting for commit().
+        std::size_t
+        size()
+            const noexcept
+        {
+            return stores.size();
+        }
+
+
+        bool
+        empty()
+            const noexcept
+        {
+            return stores.empty();
+        }
+
+
+        // Stage a store; staging the same key again replaces the previous value.
+        template<typename U>
+        void
+        store(const group& parent,
+              const key& k,
+              U&& value)
+        {
+            using T = detail::staged_type_t<U>;
+            stage(std::make_unique<detail::staged_store_for<T>>(parent,
+                                                                k,
+                                                                std::forward<U>(value)));
+        }
+
+
+        template<typename U>
+        void
+        store(const key& k,
+              U&& value)
+        {
+            store(group{}, k, std::forward<U>(value));
+        }
+
+
+        // Assign `value` to `variable` right away, and stage it for storing.
+        template<typename T,
+                 typename U>
+        void
+        assign(const group& parent,
+               const key& k,
+               T& variable,
+               U&& value)
+        {
+            backup(variable);
+            variable = std::forward<U>(value);
+            store(parent, k, variable);
+        }
+
+
+        template<typename T,
+                 typename U>
+        void
+        assign(const key& k,
+               T& variable,
+               U&& value)
+        {
+            assign(group{}, k, variable, std::forward<U>(value));
+        }
+
+
+        // Like group::load_or_init(), but the default value is only stored on commit().
+        template<typename T,
+                 typename U>
+        void
+        load_or_init(const group& parent,
+                     const key& k,
+                     T& variable,
+                     U&& init)
+        {
+            auto res = parent.load<T>(k);
+            if (res) {
+                backup(variable);
+                variable = std::move(*res);
+            } else {
+                if (res.error().code != WUPS_STORAGE_ERROR_NOT_FOUND)
+                    detail::raise(res.error());
+                assign(parent, k, variable, std::forward<U>(init));
+            }
+        }
+
+
+        template<typename T,
+                 typename U>
+        void
+        load_or_init(const key& k,
+                     T& variable,
+                     U&& init)
+        {
+            load_or_init(group{}, k, variable, std::forward<U>(init));
+        }
+
+
+        // Set every member to its default value, and stage them for storing.
+        template<typename S,
+                 typename... Ts>
+        void
+        reset(const schema<S, Ts...>& sch,
+              S& settings,
+              const group& parent = {})
+        {
+            sch.for_each([&](const auto& f)
+            {
+                assign(parent, f.k, settings.*f.member, f.default_value);
+            });
+        }
+
+
+        // Write every staged value that differs from what is in the storage.
+        // If a store fails or throws, rollback() is called, and the error is returned or
+        // rethrown.
+        // Note: this does not call save().
+        std::expected<void, storage_error> try_commit();
+
+
+        // Same as try_commit(), but the error is thrown.
+        void commit();
+
+
+        // Put back the values already written by a failed commit(), drop the staged
+        // stores, and restore the variables.
+        void rollback() noexcept;
+
+
+    private:
+
+        void stage(std::unique_ptr<detail::staged_store> entry);
+
+
+        bool is_backed_up(const void* address) const noexcept;
+
+
+        template<typename T>
+        void
+        backup(T& variable)
+        {
+            if (!is_backed_up(&variable))
+                backups.push_back(std::make_unique<detail::variable_backup_for<T>>(variable));
+        }
+
+    };
+
+} // namespace wups::storage
+
+#endif
@@ -9,20 +9,67 @@
 #ifndef WUPSXX_TEXT_ITEM_HPP
 #define WUPSXX_TEXT_ITEM_HPP
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "item.hpp"
 
 
 namespace wups::config {
 
-    // Note: this class doesn't do much on its own, so it's all public.
+    // Read-only text; when it doesn't fit, it can be scrolled with ◀/▶.
+    // Widths and positions are in display columns, so multibyte characters and Cafe
+    // glyphs are never cut in half.
+    //
+    // In marquee mode, text that doesn't fit also scrolls by itself while not focused:
+    // it waits at the start, scrolls to the end, waits again, and starts over.
 
-    struct text_item : item {
+    class text_item : public item {
 
         std::string text;
         std::size_t max_width;
-        std::size_t first = 0; // first visible character
+        std::size_t first = 0; // first visible column, always the start of a character
+
+        // Byte offset and column where each character starts, combining marks included;
+        // both have an extra entry for the end of the text.
+        std::vector<std::uint32_t> offsets;
+        std::vector<std::uint32_t> columns;
+
+    public:
+
+        // What to show in place of the text that was cut off.
+        struct marker {
+            std::string_view str;
+            std::size_t width;
+        };
+
+
+        using time_source = std::chrono::steady_clock::time_point (*)() noexcept;
+
+        struct marquee_options {
+            std::chrono::milliseconds step{200};   // time to scroll one column
+            std::chrono::milliseconds pause{1500}; // time to wait at each end
+            time_source now = std::chrono::steady_clock::now;
+        };
+
+    private:
+
+        struct marquee_state {
+            marquee_options options;
+            std::chrono::steady_clock::time_point start;
+            std::size_t last = 0; // last column where the text starts
+            mutable std::size_t shown = 0; // column that was last rendered
+        };
+
+        std::optional<marquee_state> marquee;
+
+    public:
+
 
         text_item(const std::string& label,
                   const std::string& text = "",
@@ -35,6 +82,19 @@ namespace wups::config {
                std::size_t max_width = 50);
 
 
+        const std::string& get_text() const noexcept;
+
+        void set_text(const std::string& new_text);
+
+
+        // Enable marquee mode; it restarts every time the text changes.
+        void start_marquee();
+
+        void start_marquee(const marquee_options& options);
+
+        void stop_marquee() noexcept;
+
+
         virtual void get_display(char* buf, std::size_t size) const override;
 
         virtual void get_focused_display(char* buf, std::size_t size) const override;
@@ -43,6 +103,42 @@ namespace wups::config {
 
         virtual focus_status on_input(const simple_pad_data& input) override;
 
+    protected:
+
+        virtual bool is_display_outdated() const noexcept override;
+
+
+        std::size_t get_width() const noexcept;
+
+        std::size_t get_max_width() const noexcept;
+
+        std::size_t get_first() const noexcept;
+
+        void set_first(std::size_t column) noexcept;
+
+        // Largest useful first column, for a view with `left` on the left side.
+        std::size_t last_first(const marker& left) const noexcept;
+
+
+        // Write the text starting at `start` column; this is O(visible width).
+        void
+        render(char* buf,
+               std::size_t size,
+               std::size_t start,
+               const marker& left,
+               const marker& right)
+            const noexcept;
+
+    private:
+
+        void update_index();
+
+        // Where the text starts right now, in marquee mode.
+        std::size_t marquee_column() const noexcept;
+
+        // Index of the character at `column`.
+        std::size_t char_at(std::size_t column) const noexcept;
+
     };
 
 } // namespace wups::config
@@ -9,14 +9,19 @@
 #ifndef WUPSXX_VAR_ITEM_HPP
 #define WUPSXX_VAR_ITEM_HPP
 
+#include <concepts>
 #include <optional>
 
 #include "item.hpp"
+#include "storage_observer.hpp"
 
 
 namespace wups::config {
 
     // Base class for items that map to a variable.
+    //
+    // Note: the display is cached, so if the variable is changed from outside the menu
+    // while it's open, the item shows the old value until invalidate_display() is called.
 
     template<typename T>
     class var_item : public item {
@@ -58,9 +63,17 @@ namespace wups::config {
         }
 
 
+        // Observers of the variable are notified if the value actually changed.
         void
         confirm_change()
         {
+            if (old_value) {
+                bool changed = true;
+                if constexpr (std::equality_comparable<T>)
+                    changed = *old_value != variable;
+                if (changed)
+                    storage::notify_variable(variable);
+            }
             old_value.reset();
         }
 
@@ -79,6 +92,9 @@ namespace wups::config {
         restore_default()
             override
         {
+            // Note: WUPS can call this while not focused, so remember the old value here.
+            if (!old_value)
+                old_value = variable;
             variable = default_value;
             confirm_change();
         }
@@ -6,9 +6,11 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <algorithm>            // min()
 #include <array>
 #include <stdexcept>
 #include <string>
+#include <utility>              // move()
 
 #include "wupsxx/button_combo.hpp"
 
@@ -25,31 +27,51 @@ namespace wups::utils {
     
     button_combo::button_combo(const string& str)
     {
-        auto tokens = split_view(str, "+ \t\n\r");
-        if (tokens.empty())
-            return;
-
-        // sanity check: cannot mix vpad and wpad buttons
-        unsigned num_vpad = 0;
-        unsigned num_wpad = 0;
-
-        for (auto token : tokens) {
-            if (token.starts_with("VPAD_"))
-                ++num_vpad;
-            if (token.starts_with("WPAD_"))
-                ++num_wpad;
-        }
+        auto res = parse<button_combo>(str);
+        if (!res)
+            raise<std::runtime_error>("invalid button combo \"" + str + "\": "
+                                      + message(res.error().code));
+        *this = std::move(*res);
+    }
 
-        if (num_vpad && num_wpad)
-            throw std::runtime_error{"cannot use both VPAD and WPAD buttons in the same combo"};
 
-        if (num_vpad + num_wpad != tokens.size())
-            throw std::runtime_error{"invalid token detected"};
+    template<>
+    std::expected<button_combo, parse_error>
+    parse<button_combo>(std::string_view str)
+    {
+        constexpr std::string_view separators = "+ \t\n\r";
+
+        button_combo result;
+        auto& combo = static_cast<button_combo::parent&>(result);
+
+        for (std::size_t pos = 0;;) {
+            pos = str.find_first_not_of(separators, pos);
+            if (pos == std::string_view::npos)
+                break;
+            auto end = std::min(str.find_first_of(separators, pos), str.size());
+            auto token = str.substr(pos, end - pos);
+
+            std::expected<void, parse_errc> res;
+            if (token.starts_with("VPAD_")) {
+                if (holds_alternative<wpad::button_set>(combo))
+                    return std::unexpected{parse_error{parse_errc::mixed_devices, pos}};
+                res = ensure<vpad::button_set>(combo).add(token);
+            } else if (token.starts_with("WPAD_")) {
+                if (holds_alternative<vpad::button_set>(combo))
+                    return std::unexpected{parse_error{parse_errc::mixed_devices, pos}};
+                res = ensure<wpad::button_set>(combo).add(token);
+            } else
+                res = std::unexpected{parse_errc::unknown_token};
+            // Note: unknown button names are ignored, like older versions did, so combos
+            // stored by them still load.
+            if (!res && !(res.error() == parse_errc::unknown_token
+                          && (token.starts_with("VPAD_") || token.starts_with("WPAD_"))))
+                return std::unexpected{parse_error{res.error(), pos}};
+
+            pos = end;
+        }
 
-        if (num_vpad)
-            parent::operator =(vpad::button_set{tokens});
-        else
-            parent::operator =(wpad::button_set{tokens});
+        return result;
     }
 
 
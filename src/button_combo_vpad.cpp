@@ -76,10 +76,22 @@ namespace wups::utils::vpad {
 
     button_set::button_set(const std::vector<std::string_view>& args)
     {
+        // Note: unknown names are ignored.
         for (auto token : args)
-            for (auto entry : button_entries)
-                if (entry.name == token)
-                    buttons |= entry.button;
+            (void) add(token);
+    }
+
+
+    std::expected<void, parse_errc>
+    button_set::add(std::string_view name)
+        noexcept
+    {
+        for (auto entry : button_entries)
+            if (entry.name == name) {
+                buttons |= entry.button;
+                return {};
+            }
+        return std::unexpected{parse_errc::unknown_token};
     }
 
 
@@ -264,54 +264,62 @@ namespace wups::utils::wpad {
 
     button_set::button_set(const std::vector<std::string_view>& args)
     {
-        using utils::ensure;
+        // Note: unknown names are ignored.
+        for (auto token : args) {
+            auto res = add(token);
+            if (!res && res.error() == parse_errc::mixed_extensions)
+                raise<std::runtime_error>(message(res.error()));
+        }
+    }
 
-        unsigned num_nunchuk = 0;
-        unsigned num_classic = 0;
-        unsigned num_pro = 0;
 
-        for (auto token : args) {
+    namespace {
 
-            if (token.starts_with("WPAD_BUTTON_"))
-                for (auto entry : core::button_entries)
-                    if (entry.name == token)
-                        core.buttons |= entry.button;
-
-            if (token.starts_with("WPAD_NUNCHUK_")) {
-                auto& nunchuk = ensure<nunchuk::button_set>(ext);
-                ++num_nunchuk;
-                for (auto entry : nunchuk::button_entries)
-                    if (entry.name == token)
-                        nunchuk.buttons |= entry.button;
-            }
+        template<typename Set,
+                 typename Entries>
+        std::expected<void, parse_errc>
+        add_to(ext_button_set& ext,
+               const Entries& entries,
+               std::string_view name)
+            noexcept
+        {
+            // Ensure the user didn't mix buttons from multiple extensions.
+            if (!holds_alternative<std::monostate>(ext) && !holds_alternative<Set>(ext))
+                return std::unexpected{parse_errc::mixed_extensions};
+            for (auto entry : entries)
+                if (entry.name == name) {
+                    ensure<Set>(ext).buttons |= entry.button;
+                    return {};
+                }
+            return std::unexpected{parse_errc::unknown_token};
+        }
 
-            if (token.starts_with("WPAD_CLASSIC_")) {
-                auto& classic = ensure<classic::button_set>(ext);
-                ++num_classic;
-                for (auto entry : classic::button_entries)
-                    if (entry.name == token)
-                        classic.buttons |= entry.button;
-            }
+    } // namespace
 
-            if (token.starts_with("WPAD_PRO_")) {
-                auto& pro = ensure<pro::button_set>(ext);
-                ++num_pro;
-                for (auto entry : pro::button_entries)
-                    if (entry.name == token)
-                        pro.buttons |= entry.button;
-            }
+
+    std::expected<void, parse_errc>
+    button_set::add(std::string_view name)
+        noexcept
+    {
+        if (name.starts_with("WPAD_BUTTON_")) {
+            for (auto entry : core::button_entries)
+                if (entry.name == name) {
+                    core.buttons |= entry.button;
+                    return {};
+                }
+            return std::unexpected{parse_errc::unknown_token};
         }
 
-        // Ensure the user didn't mix buttons from multiple extensions.
-        unsigned num_extensions = 0;
-        if (num_nunchuk)
-            ++num_extensions;
-        if (num_classic)
-            ++num_extensions;
-        if (num_pro)
-            ++num_extensions;
-        if (num_extensions > 1)
-            throw std::runtime_error{"cannot mix multiple extensions in combo"};
+        if (name.starts_with("WPAD_NUNCHUK_"))
+            return add_to<nunchuk::button_set>(ext, nunchuk::button_entries, name);
+
+        if (name.starts_with("WPAD_CLASSIC_"))
+            return add_to<classic::button_set>(ext, classic::button_entries, name);
+
+        if (name.starts_with("WPAD_PRO_"))
+            return add_to<pro::button_set>(ext, pro::button_entries, name);
+
+        return std::unexpected{parse_errc::unknown_token};
     }
 
 
@@ -669,7 +677,7 @@ namespace wups::utils::wpad {
     get_button_state(WPADChan channel)
     {
         if (channel < 0 || channel >= states.size()) [[unlikely]]
-            throw std::invalid_argument{"invalid wpad channel"};
+            raise<std::invalid_argument>("invalid wpad channel");
         return states[channel];
     }
 
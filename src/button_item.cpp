@@ -18,7 +18,10 @@ namespace wups::config {
     button_item::button_item(const std::string& label) :
         item{label},
         current_state{state::stopped}
-    {}
+    {
+        // The status message can change from any thread.
+        set_display_cache(false);
+    }
 
 
     void
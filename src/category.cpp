@@ -6,13 +6,151 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <chrono>
+#include <utility>              // move()
+#include <vector>
+
 #include "wupsxx/category.hpp"
 
 #include "wupsxx/config_error.hpp"
 
+#include "item_arena.hpp"
+
 
 namespace wups::config {
 
+    namespace detail {
+
+
+        struct lazy_child {
+            WUPSConfigCategoryHandle handle;
+            category::builder_type builder;
+        };
+
+
+        struct lazy_node {
+            item* trigger = nullptr; // the first item of the category
+            std::vector<lazy_child> children;
+            std::size_t next = 0; // children before this one were built already
+
+
+            void
+            attach(item* it)
+                noexcept
+            {
+                trigger = it;
+                trigger->lazy = this;
+            }
+
+
+            void
+            detach()
+                noexcept
+            {
+                if (trigger)
+                    trigger->lazy = nullptr;
+                trigger = nullptr;
+            }
+        };
+
+
+        namespace {
+
+            // WUPS lists the categories before the items; the first item is only drawn
+            // right away if it's within the first rows.
+            constexpr unsigned visible_rows = 6;
+
+            // Note: nodes live until the menu is closed, items may point to them.
+            std::vector<std::unique_ptr<lazy_node>> session_nodes;
+
+            menu_stats session_stats;
+
+
+            lazy_node*
+            new_node()
+            {
+                session_nodes.push_back(std::make_unique<lazy_node>());
+                return session_nodes.back().get();
+            }
+
+        } // namespace
+
+
+        namespace {
+
+            void
+            build_children(lazy_node* node)
+            {
+                // Note: each builder is taken out before it runs; if one throws, the
+                // others are still built the next time the trigger is shown.
+                while (node->next < node->children.size()) {
+                    auto& child = node->children[node->next++];
+                    category cat{child.handle};
+                    auto builder = std::move(child.builder);
+                    builder(cat);
+                    ++session_stats.lazy_built;
+                    finish_category(cat);
+                }
+                node->detach();
+                node->children.clear();
+            }
+
+        } // namespace
+
+
+        void
+        build_lazy(lazy_node* node)
+        {
+            using namespace std::chrono;
+            auto start = steady_clock::now();
+            build_children(node);
+            session_stats.lazy_time += duration_cast<microseconds>(steady_clock::now() - start);
+        }
+
+
+        void
+        finish_category(category& cat)
+        {
+            auto node = cat.lazy;
+            cat.lazy = nullptr;
+            if (!node)
+                return;
+            if (!cat.first_item || cat.categories >= visible_rows) {
+                // No item is sure to be shown to trigger it, so do it now.
+                build_children(node);
+                return;
+            }
+            node->attach(cat.first_item);
+        }
+
+
+        void
+        begin_menu_session()
+        {
+            session_stats = {};
+            begin_item_arena();
+        }
+
+
+        void
+        end_menu_session()
+            noexcept
+        {
+            session_nodes.clear();
+            end_item_arena();
+        }
+
+
+        menu_stats&
+        current_menu_stats()
+            noexcept
+        {
+            return session_stats;
+        }
+
+    } // namespace detail
+
+
     category::category(WUPSConfigCategoryHandle handle) :
         handle{handle},
         own_handle{false}
@@ -30,10 +168,17 @@ namespace wups::config {
 
 
     category::category(category&& other)
-        noexcept
+        noexcept :
+        handle{other.handle},
+        own_handle{other.own_handle},
+        first_item{other.first_item},
+        categories{other.categories},
+        lazy{other.lazy}
     {
-        handle = other.handle;
         other.handle = {};
+        other.first_item = nullptr;
+        other.categories = 0;
+        other.lazy = nullptr;
     }
 
 
@@ -63,6 +208,10 @@ namespace wups::config {
         if (status != WUPSCONFIG_API_RESULT_SUCCESS)
             throw config_error{status, "cannot add item to category: "};
 
+        ++detail::current_menu_stats().items;
+        if (!first_item)
+            first_item = item.get();
+
         item.release(); // WUPS will call .onDelete() later
     }
 
@@ -75,6 +224,25 @@ namespace wups::config {
             throw config_error{status, "cannot add child category to category: "};
 
         child.release();
+        // The child is complete now.
+        detail::finish_category(child);
+
+        ++categories;
+    }
+
+
+    void
+    category::add_lazy(const std::string& label,
+                       builder_type builder)
+    {
+        category child{label};
+        auto child_handle = child.handle;
+        add(std::move(child));
+
+        if (!lazy)
+            lazy = detail::new_node();
+        lazy->children.push_back({child_handle, std::move(builder)});
+        ++detail::current_menu_stats().lazy_pending;
     }
 
 } // namespace wups::config
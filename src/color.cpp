@@ -6,44 +6,56 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <charconv>             // from_chars()
 #include <cstdio>
 #include <stdexcept>
+#include <system_error>         // errc
 
 #include "wupsxx/color.hpp"
 
+#include "utils.hpp"
+
 
 namespace wups::utils {
 
     color::color(const std::string& str)
     {
-        if (str.empty() || str[0] != '#')
-            throw std::invalid_argument{"color must start with '#' character"};
-
-        std::size_t pos = 0;
-        std::uint32_t val = std::stoul(str.substr(1), &pos, 16);
-        if (pos != str.size() - 1)
-            throw std::invalid_argument{"color string \"" + str +
-                                        "\" contains invalid chars at pos=" + std::to_string(pos)};
-
-        auto len = str.size();
-
-        color c;
-        switch (len) {
-        case 1 + 6: // #RRGGBB
-            r = (val >> 16) & 0xff;
-            g = (val >>  8) & 0xff;
-            b = (val >>  0) & 0xff;
-            a = 0xff;
-            break;
-        case 1 + 8: // #RRGGBBAA
-            r = (val >> 24) & 0xff;
-            g = (val >> 16) & 0xff;
-            b = (val >>  8) & 0xff;
-            a = (val >>  0) & 0xff;
-            break;
-        default:
-            throw std::invalid_argument{"invalid length for color string: \"" + str + "\""};
-        }
+        auto res = parse<color>(str);
+        if (!res)
+            raise<std::invalid_argument>("invalid color string \"" + str + "\": "
+                                         + message(res.error().code)
+                                         + " at pos=" + std::to_string(res.error().pos));
+        *this = *res;
+    }
+
+
+    template<>
+    std::expected<color, parse_error>
+    parse<color>(std::string_view str)
+    {
+        if (str.empty())
+            return std::unexpected{parse_error{parse_errc::empty}};
+        if (str[0] != '#')
+            return std::unexpected{parse_error{parse_errc::invalid_char, 0}};
+
+        auto digits = str.substr(1);
+        // Note: checked first, so too many digits is not reported as an overflow.
+        if (digits.size() != 6 && digits.size() != 8)
+            return std::unexpected{parse_error{parse_errc::invalid_length, str.size()}};
+
+        std::uint32_t val = 0;
+        auto [ptr, ec] = std::from_chars(digits.data(),
+                                         digits.data() + digits.size(),
+                                         val,
+                                         16);
+        if (ec != std::errc{} || ptr != digits.data() + digits.size())
+            return std::unexpected{parse_error{parse_errc::invalid_char,
+                                               1 + static_cast<std::size_t>(ptr - digits.data())}};
+
+        if (digits.size() == 6) // #RRGGBB
+            return color(val >> 16, val >> 8, val, 0xff);
+        // #RRGGBBAA
+        return color(val >> 24, val >> 16, val >> 8, val);
     }
 
 
@@ -0,0 +1,53 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "wupsxx/fixed_item.hpp"
+
+
+namespace wups::config {
+
+    fixed_item::fixed_item(const std::string& label,
+                           int& variable, int default_value,
+                           int min_value, int max_value,
+                           int scale,
+                           int fast_increment, int slow_increment,
+                           const utils::number_format& format) :
+        numeric_item<int>{label,
+                          variable, default_value,
+                          min_value, max_value,
+                          fast_increment, slow_increment,
+                          format},
+        scale{scale}
+    {}
+
+
+    std::unique_ptr<fixed_item>
+    fixed_item::create(const std::string& label,
+                       int& variable, int default_value,
+                       int min_value, int max_value,
+                       int scale,
+                       int fast_increment, int slow_increment,
+                       const utils::number_format& format)
+    {
+        return std::make_unique<fixed_item>(label,
+                                            variable, default_value,
+                                            min_value, max_value,
+                                            scale,
+                                            fast_increment, slow_increment,
+                                            format);
+    }
+
+
+    void
+    fixed_item::format_value(char* buf, std::size_t size, int value)
+        const
+    {
+        utils::format_fixed(buf, size, value, scale, format);
+    }
+
+} // namespace wups::config
@@ -0,0 +1,13 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "numeric_item_impl.hpp"
+
+
+template class wups::config::numeric_item<float>;
+template class wups::config::numeric_item<double>;
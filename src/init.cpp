@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <chrono>
 #include <utility>
 #include <stdexcept>
 
@@ -30,9 +31,16 @@ namespace wups::config {
                 if (!open_callback)
                     return WUPSCONFIG_API_CALLBACK_RESULT_ERROR;
 
+                using namespace std::chrono;
+                auto start = steady_clock::now();
+                detail::begin_menu_session();
+
                 category root{root_handle};
                 open_callback(root);
+                detail::finish_category(root);
 
+                detail::current_menu_stats().open_time =
+                    duration_cast<microseconds>(steady_clock::now() - start);
                 return WUPSCONFIG_API_CALLBACK_RESULT_SUCCESS;
             }
             catch (std::exception& e) {
@@ -51,6 +59,7 @@ namespace wups::config {
         menu_close()
             noexcept
         {
+            detail::end_menu_session();
             try {
                 if (close_callback)
                     close_callback();
@@ -83,4 +92,12 @@ namespace wups::config {
     }
 
 
+    menu_stats
+    get_menu_stats()
+        noexcept
+    {
+        return detail::current_menu_stats();
+    }
+
+
 } // namespace wups
@@ -8,8 +8,10 @@
 
 #include <array>
 #include <chrono>
+#include <cstddef>              // size_t
 #include <cstdint>
 #include <ranges>
+#include <utility>              // pair
 
 #include <padscore/wpad.h>
 #include <vpad/input.h>
@@ -21,7 +23,19 @@ using std::array;
 using std::uint32_t;
 using std::chrono::steady_clock;
 using time_point = steady_clock::time_point;
+
+#ifdef __cpp_lib_ranges_enumerate
 using std::views::enumerate;
+#else
+// Note: only for host builds with older compilers (GCC 12.)
+template<typename R>
+auto
+enumerate(const R& r)
+{
+    return std::views::iota(std::size_t{0}, std::ranges::size(r))
+        | std::views::transform([&r](std::size_t i) { return std::pair{i, r[i]}; });
+}
+#endif
 
 using namespace std::literals;
 
@@ -7,6 +7,8 @@
  */
 
 #include <cstdio>               // snprintf()
+#include <cstring>              // memcpy(), strnlen()
+#include <new>                  // nothrow
 
 #include <whb/log.h>
 
@@ -16,6 +18,8 @@
 
 #include "wupsxx/config_error.hpp"
 
+#include "item_arena.hpp"
+
 
 #define REPORT_ERROR(e) \
     WHBLogPrintf("[libwupsxx] error in %s(): %s\n", __func__, e.what())
@@ -35,7 +39,7 @@ namespace wups::config {
         {
             try {
                 auto it = static_cast<const item*>(ctx);
-                it->get_display(buf, size);
+                it->render_display(buf, size, false);
                 return 0;
             }
             catch (std::exception& e) {
@@ -51,10 +55,7 @@ namespace wups::config {
         {
             try {
                 auto it = static_cast<const item*>(ctx);
-                if (it->has_focus())
-                    it->get_focused_display(buf, size);
-                else
-                    it->get_display(buf, size);
+                it->render_display(buf, size, true);
                 return 0;
             }
             catch (std::exception& e) {
@@ -86,6 +87,7 @@ namespace wups::config {
             try {
                 auto it = static_cast<item*>(ctx);
                 it->on_close();
+                it->invalidate_display();
             }
             catch (std::exception& e) {
                 REPORT_ERROR(e);
@@ -126,6 +128,10 @@ namespace wups::config {
 
                 simple_pad_data sinput{input};
                 auto res = it->on_input(sinput);
+                // Idle frames can't change anything, so they keep the cache.
+                if (res != focus_status::keep
+                    || sinput.buttons_d || sinput.buttons_r || sinput.buttons_repeat)
+                    it->invalidate_display();
                 switch (res) {
                 case focus_status::lose:
                     it->set_focus(false);
@@ -165,6 +171,8 @@ namespace wups::config {
 
                 complex_pad_data cinput{input};
                 auto res = it->on_input(cinput);
+                // Complex input reads held buttons, any frame can change the display.
+                it->invalidate_display();
                 switch (res) {
                 case focus_status::lose:
                     it->set_focus(false);
@@ -196,6 +204,7 @@ namespace wups::config {
             try {
                 auto it = static_cast<item*>(ctx);
                 it->restore_default();
+                it->invalidate_display();
             }
             catch (std::exception& e) {
                 REPORT_ERROR(e);
@@ -234,6 +243,8 @@ namespace wups::config {
 
     item::~item()
     {
+        delete[] unfocused_cache.buf;
+        delete[] focused_cache.buf;
         if (handle.handle) {
             /* How to get here:
              *   - Destructor was called from user code.
@@ -245,6 +256,21 @@ namespace wups::config {
     }
 
 
+    void*
+    item::operator new(std::size_t size)
+    {
+        return detail::allocate_item(size);
+    }
+
+
+    void
+    item::operator delete(void* ptr)
+        noexcept
+    {
+        detail::deallocate_item(ptr);
+    }
+
+
     void
     item::release()
         noexcept
@@ -352,6 +378,7 @@ namespace wups::config {
             if (focused) // always enter focus on simple mode
                 current_mode = input_mode::simple;
             on_focus_changed();
+            invalidate_display();
         }
     }
 
@@ -372,4 +399,74 @@ namespace wups::config {
     }
 
 
+    void
+    item::set_display_cache(bool enable)
+        noexcept
+    {
+        cache_enabled = enable;
+        invalidate_display();
+    }
+
+
+    bool
+    item::is_display_outdated()
+        const noexcept
+    {
+        return false;
+    }
+
+
+    void
+    item::invalidate_display()
+        noexcept
+    {
+        unfocused_cache.length = 0;
+        focused_cache.length = 0;
+    }
+
+
+    void
+    item::render_display(char* buf,
+                         std::size_t size,
+                         bool selected)
+        const
+    {
+        // The user may enter the sibling categories once this is shown.
+        if (lazy)
+            detail::build_lazy(lazy);
+
+        const bool show_focused = selected && focused;
+        auto& cache = show_focused ? focused_cache : unfocused_cache;
+
+        if (cache_enabled && size > cache.capacity && size <= UINT16_MAX) {
+            // Note: WUPS always asks with the same size, so this normally happens once.
+            // Not from the item arena, or it would keep the whole arena alive.
+            delete[] cache.buf;
+            cache.buf = new (std::nothrow) char[size];
+            cache.capacity = cache.buf ? size : 0;
+            cache.size = 0;
+        }
+
+        if (!cache_enabled || size == 0 || size > cache.capacity) {
+            if (show_focused)
+                get_focused_display(buf, size);
+            else
+                get_display(buf, size);
+            return;
+        }
+
+        if (cache.size != size || !cache.length || is_display_outdated()) {
+            cache.buf[0] = '\0'; // in case nothing gets written
+            if (show_focused)
+                get_focused_display(cache.buf, size);
+            else
+                get_display(cache.buf, size);
+            cache.length = strnlen(cache.buf, size - 1) + 1;
+            cache.buf[cache.length - 1] = '\0';
+            cache.size = size;
+        }
+        std::memcpy(buf, cache.buf, cache.length);
+    }
+
+
 } // namespace wups::config
@@ -0,0 +1,159 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // max()
+#include <cstddef>              // max_align_t
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "item_arena.hpp"
+
+#include "wupsxx/category.hpp"  // menu_stats
+
+
+namespace wups::config::detail {
+
+    namespace {
+
+        constexpr std::size_t block_size = 8 * 1024;
+
+        // Every allocation starts with a header that points to its arena, or null if it
+        // came from the heap.
+        constexpr std::size_t header_size = alignof(std::max_align_t);
+
+
+        constexpr
+        std::size_t
+        align_up(std::size_t n)
+            noexcept
+        {
+            return (n + header_size - 1) / header_size * header_size;
+        }
+
+
+        class arena {
+
+            struct block {
+                std::unique_ptr<std::byte[]> data;
+                std::size_t size;
+                std::size_t used;
+            };
+
+            std::vector<block> blocks;
+            std::size_t live = 0;
+            bool open = true;
+
+        public:
+
+            void*
+            allocate(std::size_t size)
+            {
+                size = align_up(size);
+                if (blocks.empty() || blocks.back().size - blocks.back().used < size) {
+                    // Oversized allocations get a block of their own.
+                    std::size_t new_size = std::max(size, block_size);
+                    blocks.push_back({std::make_unique<std::byte[]>(new_size), new_size, 0});
+                    current_menu_stats().item_memory += new_size;
+                }
+                auto& b = blocks.back();
+                void* ptr = b.data.get() + b.used;
+                b.used += size;
+                ++live;
+                return ptr;
+            }
+
+
+            // Return true when the arena can be destroyed.
+            bool
+            deallocate()
+                noexcept
+            {
+                --live;
+                return !open && live == 0;
+            }
+
+
+            bool
+            close()
+                noexcept
+            {
+                open = false;
+                return live == 0;
+            }
+
+        };
+
+
+        arena* current = nullptr;
+
+        // Arenas from previous sessions, that still have items alive.
+        std::vector<std::unique_ptr<arena>> arenas;
+
+
+        void
+        destroy(arena* a)
+            noexcept
+        {
+            std::erase_if(arenas, [a](const auto& p) { return p.get() == a; });
+        }
+
+    } // namespace
+
+
+    void
+    begin_item_arena()
+    {
+        end_item_arena();
+        arenas.push_back(std::make_unique<arena>());
+        current = arenas.back().get();
+    }
+
+
+    void
+    end_item_arena()
+        noexcept
+    {
+        if (!current)
+            return;
+        if (current->close())
+            destroy(current);
+        current = nullptr;
+    }
+
+
+    void*
+    allocate_item(std::size_t size)
+    {
+        std::byte* ptr;
+        if (current)
+            ptr = static_cast<std::byte*>(current->allocate(header_size + size));
+        else
+            ptr = static_cast<std::byte*>(::operator new(header_size + size));
+        *reinterpret_cast<arena**>(ptr) = current;
+        return ptr + header_size;
+    }
+
+
+    void
+    deallocate_item(void* ptr)
+        noexcept
+    {
+        if (!ptr)
+            return;
+        auto base = static_cast<std::byte*>(ptr) - header_size;
+        arena* owner = *reinterpret_cast<arena**>(base);
+        if (!owner) {
+            ::operator delete(base);
+            return;
+        }
+        if (owner->deallocate())
+            destroy(owner);
+    }
+
+} // namespace wups::config::detail
@@ -0,0 +1,39 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ITEM_ARENA_HPP
+#define ITEM_ARENA_HPP
+
+#include <cstddef>
+
+
+// Items created while the menu is open are allocated from an arena, so opening and
+// closing the menu doesn't fragment the heap. Items are still destroyed one by one (by
+// WUPS, or by user code), but their memory is only freed once the menu was closed and
+// the last item of that session is gone.
+//
+// Note: like the rest of the menu code, this is not thread-safe; items must be created
+// and destroyed from the menu thread.
+
+
+namespace wups::config::detail {
+
+    // All allocations after this come from a new arena.
+    void begin_item_arena();
+
+    // No more allocations come from the current arena.
+    void end_item_arena() noexcept;
+
+
+    void* allocate_item(std::size_t size);
+
+    void deallocate_item(void* ptr) noexcept;
+
+} // namespace wups::config::detail
+
+#endif
@@ -83,11 +83,11 @@ namespace wups::logger {
     }
 
 
-    void
-    vprintf(const char* fmt, std::va_list args)
-        noexcept
-    {
-        try {
+    namespace {
+
+        void
+        write(const char* fmt, std::va_list args)
+        {
             std::lock_guard guard{mut};
             if (refs == 0)
                 return;
@@ -108,7 +108,22 @@ namespace wups::logger {
                 WHBLogWrite(buf.c_str());
             }
         }
+
+    } // namespace
+
+
+    void
+    vprintf(const char* fmt, std::va_list args)
+        noexcept
+    {
+#ifdef __cpp_exceptions
+        try {
+            write(fmt, args);
+        }
         catch (...) {}
+#else
+        write(fmt, args);
+#endif
     }
 
 
@@ -0,0 +1,108 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <chrono>
+#include <stdexcept>            // logic_error
+
+#include "wupsxx/menu_schema.hpp"
+
+#include "wupsxx/bool_item.hpp"
+#include "wupsxx/button_combo_item.hpp"
+#include "wupsxx/color_item.hpp"
+#include "wupsxx/duration_items.hpp"
+#include "wupsxx/file_item.hpp"
+#include "wupsxx/float_item.hpp"
+#include "wupsxx/int_item.hpp"
+
+
+namespace wups::config::detail {
+
+    template<typename T>
+    std::unique_ptr<item>
+    make_item(const std::string& label,
+              T& variable,
+              const T& default_value,
+              const item_options<T>& options)
+    {
+        if constexpr (std::is_same_v<T, bool>)
+            return bool_item::create(label, variable, default_value,
+                                     options.true_str, options.false_str);
+        else if constexpr (std::is_same_v<T, utils::color>)
+            return color_item::create(label, variable, default_value,
+                                      options.has_alpha);
+        else if constexpr (std::is_same_v<T, std::filesystem::path>)
+            return file_item::create(label, variable, default_value,
+                                     options.max_width, options.extensions);
+        else if constexpr (std::is_same_v<T, utils::button_combo>)
+            return button_combo_item::create(label, variable, default_value);
+        else {
+            if (!(options.min_value < options.max_value))
+                throw std::logic_error{"empty range for setting \"" + label + "\""};
+            return numeric_item<T>::create(label, variable, default_value,
+                                           options.min_value, options.max_value,
+                                           options.fast_increment, options.slow_increment);
+        }
+    }
+
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, bool&, const bool&,
+              const item_options<bool>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, utils::color&, const utils::color&,
+              const item_options<utils::color>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, std::filesystem::path&, const std::filesystem::path&,
+              const item_options<std::filesystem::path>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, utils::button_combo&, const utils::button_combo&,
+              const item_options<utils::button_combo>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, int&, const int&,
+              const item_options<int>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, float&, const float&,
+              const item_options<float>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, double&, const double&,
+              const item_options<double>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, std::chrono::milliseconds&, const std::chrono::milliseconds&,
+              const item_options<std::chrono::milliseconds>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, std::chrono::seconds&, const std::chrono::seconds&,
+              const item_options<std::chrono::seconds>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, std::chrono::minutes&, const std::chrono::minutes&,
+              const item_options<std::chrono::minutes>&);
+
+    template
+    std::unique_ptr<item>
+    make_item(const std::string&, std::chrono::hours&, const std::chrono::hours&,
+              const item_options<std::chrono::hours>&);
+
+} // namespace wups::config::detail
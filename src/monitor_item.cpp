@@ -0,0 +1,88 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdio>               // snprintf()
+#include <utility>              // move()
+
+#include "wupsxx/monitor_item.hpp"
+
+
+namespace wups::config {
+
+    monitor_item::monitor_item(const std::string& label,
+                               getter_type getter,
+                               const options& opts) :
+        item{label},
+        getter{std::move(getter)},
+        opts{opts}
+    {}
+
+
+    std::unique_ptr<monitor_item>
+    monitor_item::create(const std::string& label,
+                         getter_type getter,
+                         const options& opts)
+    {
+        return std::make_unique<monitor_item>(label, std::move(getter), opts);
+    }
+
+
+    void
+    monitor_item::refresh()
+        noexcept
+    {
+        sampled = false;
+        invalidate_display();
+    }
+
+
+    void
+    monitor_item::get_display(char* buf,
+                              std::size_t size)
+        const
+    {
+        if (is_display_outdated())
+            sample();
+        std::snprintf(buf, size, "%s", value);
+    }
+
+
+    bool
+    monitor_item::on_focus_request(bool new_focus)
+        const
+    {
+        // Nothing to edit.
+        return !new_focus;
+    }
+
+
+    bool
+    monitor_item::is_display_outdated()
+        const noexcept
+    {
+        return !sampled || opts.now() - last_sample >= opts.interval;
+    }
+
+
+    void
+    monitor_item::sample()
+        const
+    {
+        if (!getter)
+            return;
+        char tmp[sizeof value];
+        tmp[0] = '\0';
+        // When the data is busy, try again on the next frame.
+        if (!getter(tmp, sizeof tmp))
+            return;
+        std::snprintf(value, sizeof value, "%s", tmp);
+        last_sample = opts.now();
+        sampled = true;
+    }
+
+} // namespace wups::config
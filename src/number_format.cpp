@@ -0,0 +1,156 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // min()
+
+#include "wupsxx/number_format.hpp"
+
+
+namespace wups::utils::detail {
+
+    namespace {
+
+        class char_writer {
+
+            char* buf;
+            std::size_t size;
+            std::size_t used = 0;
+
+        public:
+
+            char_writer(char* buf, std::size_t size) noexcept :
+                buf{buf},
+                size{size}
+            {}
+
+
+            void
+            put(char c)
+                noexcept
+            {
+                if (used + 1 < size)
+                    buf[used++] = c;
+            }
+
+
+            void
+            put(std::string_view str)
+                noexcept
+            {
+                for (char c : str)
+                    put(c);
+            }
+
+
+            std::size_t
+            finish()
+                noexcept
+            {
+                if (size)
+                    buf[used] = '\0';
+                return used;
+            }
+
+        };
+
+    } // namespace
+
+
+    std::size_t
+    finish_number(char* buf,
+                  std::size_t size,
+                  std::string_view digits,
+                  std::string_view unit,
+                  const number_format& fmt)
+        noexcept
+    {
+        char_writer out{buf, size};
+
+        if (digits.starts_with('-')) {
+            out.put('-');
+            digits.remove_prefix(1);
+        }
+
+        // The integer part ends at the decimal point or the exponent.
+        auto int_len = digits.find_first_not_of("0123456789");
+        if (int_len == std::string_view::npos)
+            int_len = digits.size();
+
+        for (std::size_t i = 0; i < int_len; ++i) {
+            if (fmt.thousands_sep && i > 0 && (int_len - i) % 3 == 0)
+                out.put(fmt.thousands_sep);
+            out.put(digits[i]);
+        }
+        out.put(digits.substr(int_len));
+        out.put(unit);
+        out.put(fmt.suffix);
+
+        return out.finish();
+    }
+
+} // namespace wups::utils::detail
+
+
+namespace wups::utils {
+
+    std::size_t
+    format_fixed(char* buf,
+                 std::size_t size,
+                 std::int32_t ticks,
+                 std::int32_t scale,
+                 const number_format& fmt)
+        noexcept
+    {
+        if (scale <= 0)
+            return detail::finish_number(buf, size, "?", {}, fmt);
+
+        constexpr int max_decimals = 9;
+        int decimals = fmt.precision;
+        if (decimals < 0) {
+            decimals = 3;
+            std::int64_t p = 1;
+            for (int d = 0; d <= 6; ++d, p *= 10)
+                if (p % scale == 0) {
+                    decimals = d;
+                    break;
+                }
+        }
+        decimals = std::min(decimals, max_decimals);
+
+        std::uint64_t unit = 1;
+        for (int d = 0; d < decimals; ++d)
+            unit *= 10;
+
+        // Round half away from zero. This can't overflow: ticks < 2³¹, unit <= 10⁹.
+        const bool negative = ticks < 0;
+        const std::uint64_t magnitude = negative ? -static_cast<std::int64_t>(ticks) : ticks;
+        const std::uint64_t scaled = (magnitude * unit + scale / 2) / scale;
+        const std::uint64_t whole = scaled / unit;
+        std::uint64_t frac = scaled % unit;
+
+        char tmp[32];
+        char* end = tmp + sizeof tmp;
+        char* first = end;
+        for (int d = 0; d < decimals; ++d) {
+            *--first = '0' + frac % 10;
+            frac /= 10;
+        }
+        if (decimals > 0)
+            *--first = '.';
+        auto w = whole;
+        do {
+            *--first = '0' + w % 10;
+            w /= 10;
+        } while (w);
+        if (negative && scaled != 0)
+            *--first = '-';
+
+        return detail::finish_number(buf, size, {first, end}, {}, fmt);
+    }
+
+} // namespace wups::utils
@@ -11,15 +11,14 @@
 
 #include <algorithm>            // clamp()
 #include <chrono>
+#include <cmath>                // round()
+#include <concepts>             // floating_point
 #include <cstdio>               // snprintf()
 #include <exception>
-#include <string.h>             // BSD strlcpy()
 
 #include "wupsxx/numeric_item.hpp"
 
 #include "wupsxx/cafe_glyphs.h"
-#include "wupsxx/duration.hpp" // make to_string() overload visible
-
 
 
 namespace wups::config {
@@ -28,12 +27,14 @@ namespace wups::config {
     numeric_item<T>::numeric_item(const std::string& label,
                                   T& variable, T default_value,
                                   T min_value, T max_value,
-                                  T fast_increment, T slow_increment) :
+                                  T fast_increment, T slow_increment,
+                                  const utils::number_format& format) :
         var_item<T>{label, variable, default_value},
         min_value{min_value},
         max_value{max_value},
         fast_increment{fast_increment},
-        slow_increment{slow_increment}
+        slow_increment{slow_increment},
+        format{format}
     {}
 
 
@@ -42,12 +43,14 @@ namespace wups::config {
     numeric_item<T>::create(const std::string& label,
                             T& variable, T default_value,
                             T min_value, T max_value,
-                            T fast_increment, T slow_increment)
+                            T fast_increment, T slow_increment,
+                            const utils::number_format& format)
     {
         return std::make_unique<numeric_item<T>>(label,
                                                  variable, default_value,
                                                  min_value, max_value,
-                                                 fast_increment, slow_increment);
+                                                 fast_increment, slow_increment,
+                                                 format);
     }
 
 
@@ -56,10 +59,7 @@ namespace wups::config {
     numeric_item<T>::get_display(char* buf, std::size_t size)
         const
     {
-        using std::to_string;
-        using wups::utils::to_string;
-        std::string str = to_string(variable);
-        ::strlcpy(buf, str.c_str(), size);
+        format_value(buf, size, variable);
     }
 
 
@@ -79,14 +79,13 @@ namespace wups::config {
             slow_right = " " CAFE_GLYPH_BTN_RIGHT;
             fast_right = CAFE_GLYPH_BTN_R;
         }
-        using std::to_string;
-        using wups::utils::to_string;
-        std::string str = to_string(variable);
+        char str[64];
+        format_value(str, sizeof str, variable);
         std::snprintf(buf, size,
                       "%s%s" "%s" "%s%s",
                       fast_left,
                       slow_left,
-                      str.c_str(),
+                      str,
                       slow_right,
                       fast_right);
     }
@@ -96,6 +95,8 @@ namespace wups::config {
     focus_status
     numeric_item<T>::on_input(const simple_pad_data& input)
     {
+        const T old_value = variable;
+
         if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_LEFT))
             variable -= slow_increment;
 
@@ -108,11 +109,28 @@ namespace wups::config {
         if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_R))
             variable += fast_increment;
 
+        if constexpr (std::floating_point<T>) {
+            // Snap to a multiple of the slow increment, counted from the minimum, so
+            // rounding errors don't pile up as the value is stepped around.
+            if (variable != old_value && slow_increment > T{0})
+                variable = min_value
+                    + std::round((variable - min_value) / slow_increment) * slow_increment;
+        }
+
         variable = std::clamp(variable, min_value, max_value);
 
         return var_item<T>::on_input(input);
     }
 
+
+    template<typename T>
+    void
+    numeric_item<T>::format_value(char* buf, std::size_t size, T value)
+        const
+    {
+        utils::format_number(buf, size, value, format);
+    }
+
 } // namespace wups::config
 
 
@@ -0,0 +1,49 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "wupsxx/parse.hpp"
+
+
+namespace wups::utils {
+
+    const char*
+    message(parse_errc code)
+        noexcept
+    {
+        switch (code) {
+        case parse_errc::empty:
+            return "empty string";
+        case parse_errc::invalid_char:
+            return "invalid character";
+        case parse_errc::invalid_length:
+            return "invalid length";
+        case parse_errc::out_of_range:
+            return "value out of range";
+        case parse_errc::inexact:
+            return "value can't be represented exactly";
+        case parse_errc::unknown_token:
+            return "unknown token";
+        case parse_errc::unknown_unit:
+            return "unknown unit";
+        case parse_errc::mixed_devices:
+            return "cannot use both VPAD and WPAD buttons in the same combo";
+        case parse_errc::mixed_extensions:
+            return "cannot mix multiple extensions in combo";
+        }
+        return "unknown error";
+    }
+
+
+    template<>
+    std::expected<std::filesystem::path, parse_error>
+    parse<std::filesystem::path>(std::string_view str)
+    {
+        return std::filesystem::path{str};
+    }
+
+} // namespace wups::utils
@@ -0,0 +1,125 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <iterator>             // make_move_iterator()
+#include <utility>              // move()
+
+#include "wupsxx/save_scheduler.hpp"
+
+#include "wupsxx/storage.hpp"
+
+
+using std::chrono::steady_clock;
+
+
+namespace wups::storage {
+
+    save_scheduler::save_scheduler(std::chrono::milliseconds delay,
+                                   callback_type callback) :
+        delay{delay},
+        callback{std::move(callback)}
+    {}
+
+
+    save_scheduler::~save_scheduler()
+    {
+        flush();
+    }
+
+
+    void
+    save_scheduler::set_callback(callback_type new_callback)
+    {
+        std::lock_guard guard{mutex};
+        callback = std::move(new_callback);
+    }
+
+
+    void
+    save_scheduler::request()
+    {
+        auto taken = detail::take_snapshots();
+        std::lock_guard guard{mutex};
+        // Note: stored in order, so newer copies of the same value win.
+        for (auto& snapshot : taken)
+            snapshots.push_back(std::move(snapshot));
+        pending = true;
+        deadline = steady_clock::now() + delay;
+        start_worker();
+        cond.notify_all();
+    }
+
+
+    void
+    save_scheduler::flush()
+    {
+        auto taken = detail::take_snapshots();
+        std::jthread old_worker;
+        {
+            std::lock_guard guard{mutex};
+            for (auto& snapshot : taken)
+                snapshots.push_back(std::move(snapshot));
+            // Note: this also retries a batch that failed to save.
+            if (!snapshots.empty()) {
+                pending = true;
+                start_worker();
+            }
+            old_worker = std::move(worker);
+        }
+        // Note: the thread saves anything pending before it finishes.
+        if (old_worker.joinable()) {
+            old_worker.request_stop();
+            old_worker.join();
+        }
+    }
+
+
+    void
+    save_scheduler::start_worker()
+    {
+        if (!worker.joinable())
+            worker = std::jthread{[this](std::stop_token token) { run(token); }};
+    }
+
+
+    void
+    save_scheduler::run(std::stop_token token)
+    {
+        std::unique_lock lock{mutex};
+        for (;;) {
+            cond.wait(lock, token, [this] { return pending; });
+            if (!pending)
+                return; // stop was requested, nothing left to save
+
+            // Wait until no more requests arrive; request() pushes the deadline forward.
+            while (!token.stop_requested() && steady_clock::now() < deadline)
+                cond.wait_until(lock, token, deadline, [] { return false; });
+
+            pending = false;
+            auto batch = std::move(snapshots);
+            snapshots.clear();
+            auto cb = callback;
+            lock.unlock();
+
+            result_type result = detail::try_save_snapshots(batch);
+            if (cb)
+                cb(result);
+
+            lock.lock();
+            if (!result) {
+                // Keep the values for the next save; newer copies still go after them.
+                snapshots.insert(snapshots.begin(),
+                                 std::make_move_iterator(batch.begin()),
+                                 std::make_move_iterator(batch.end()));
+            }
+            if (token.stop_requested() && !pending)
+                return;
+        }
+    }
+
+} // namespace wups::storage
@@ -0,0 +1,546 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // search()
+#include <array>
+#include <cstdio>               // snprintf()
+#include <utility>              // move()
+
+#include <padscore/kpad.h>
+#include <vpad/input.h>
+
+#include "wupsxx/search_item.hpp"
+
+#include "wupsxx/cafe_glyphs.h"
+
+
+namespace wups::config {
+
+    namespace {
+
+        // What the buttons do while typing.
+        enum key : unsigned {
+            key_next  = 1u << 0,
+            key_prev  = 1u << 1,
+            key_add   = 1u << 2,
+            key_erase = 1u << 3,
+            key_done  = 1u << 4,
+        };
+
+
+        struct key_map {
+            std::uint32_t next;
+            std::uint32_t prev;
+            std::uint32_t add;
+            std::uint32_t erase;
+            std::uint32_t done;
+        };
+
+
+        constexpr key_map vpad_keys{
+            VPAD_BUTTON_UP | VPAD_STICK_L_EMULATION_UP,
+            VPAD_BUTTON_DOWN | VPAD_STICK_L_EMULATION_DOWN,
+            VPAD_BUTTON_A,
+            VPAD_BUTTON_B,
+            VPAD_BUTTON_PLUS | VPAD_BUTTON_X,
+        };
+
+        constexpr key_map wpad_keys{
+            WPAD_BUTTON_UP,
+            WPAD_BUTTON_DOWN,
+            WPAD_BUTTON_A,
+            WPAD_BUTTON_B,
+            WPAD_BUTTON_PLUS | WPAD_BUTTON_1,
+        };
+
+        constexpr key_map classic_keys{
+            WPAD_CLASSIC_BUTTON_UP,
+            WPAD_CLASSIC_BUTTON_DOWN,
+            WPAD_CLASSIC_BUTTON_A,
+            WPAD_CLASSIC_BUTTON_B,
+            WPAD_CLASSIC_BUTTON_PLUS | WPAD_CLASSIC_BUTTON_X,
+        };
+
+        constexpr key_map pro_keys{
+            WPAD_PRO_BUTTON_UP,
+            WPAD_PRO_BUTTON_DOWN,
+            WPAD_PRO_BUTTON_A,
+            WPAD_PRO_BUTTON_B,
+            WPAD_PRO_BUTTON_PLUS | WPAD_PRO_BUTTON_X,
+        };
+
+
+        unsigned
+        translate(std::uint32_t pressed,
+                  const key_map& map)
+            noexcept
+        {
+            unsigned keys = 0;
+            if (pressed & map.next)
+                keys |= key_next;
+            if (pressed & map.prev)
+                keys |= key_prev;
+            if (pressed & map.add)
+                keys |= key_add;
+            if (pressed & map.erase)
+                keys |= key_erase;
+            if (pressed & map.done)
+                keys |= key_done;
+            return keys;
+        }
+
+
+        // Keys that were pressed or repeated, from any controller.
+        unsigned
+        read_keys(const complex_pad_data& input)
+            noexcept
+        {
+            unsigned keys = 0;
+
+            if (input.vpad.vpadError == VPAD_READ_SUCCESS)
+                keys |= translate(input.vpad.data.trigger | input.vpad_repeat, vpad_keys);
+
+            for (unsigned w = 0; w < complex_pad_data::max_wiimotes; ++w) {
+                if (input.kpad.kpadError[w] != KPAD_ERROR_OK)
+                    continue;
+                const KPADStatus& status = input.kpad.data[w];
+                const std::uint32_t ext_pressed = input.kpad_ext_repeat[w];
+                switch (status.extensionType) {
+                case WPAD_EXT_CLASSIC:
+                case WPAD_EXT_MPLUS_CLASSIC:
+                    keys |= translate(status.classic.trigger | ext_pressed, classic_keys);
+                    break;
+                case WPAD_EXT_PRO_CONTROLLER:
+                    keys |= translate(status.pro.trigger | ext_pressed, pro_keys);
+                    continue; // core buttons are not reported
+                }
+                keys |= translate(status.trigger | input.kpad_core_repeat[w], wpad_keys);
+            }
+
+            return keys;
+        }
+
+
+        char
+        to_lower(char c)
+            noexcept
+        {
+            if (c >= 'A' && c <= 'Z')
+                return c - 'A' + 'a';
+            return c;
+        }
+
+
+        // Where the lowercase `query` is in `label`, ignoring case; npos if it isn't.
+        std::size_t
+        find_nocase(const std::string& label,
+                    const std::string& query,
+                    std::size_t start = 0)
+            noexcept
+        {
+            auto it = std::search(label.begin() + start, label.end(),
+                                  query.begin(), query.end(),
+                                  [](char a, char b) { return to_lower(a) == b; });
+            if (it == label.end() && !query.empty())
+                return std::string::npos;
+            return it - label.begin();
+        }
+
+
+        // Mark `c` if it's printable ASCII.
+        void
+        mark(std::array<bool, 128>& seen,
+             char c)
+            noexcept
+        {
+            if (c >= ' ' && c <= '~')
+                seen[c] = true;
+        }
+
+    } // namespace
+
+
+    search_item::search_item(const std::string& label,
+                             match_mode mode) :
+        item{label},
+        mode{mode}
+    {}
+
+
+    std::unique_ptr<search_item>
+    search_item::create(const std::string& label,
+                        match_mode mode)
+    {
+        return std::make_unique<search_item>(label, mode);
+    }
+
+
+    void
+    search_item::add_target(item& target,
+                            const std::string& label)
+    {
+        entries.emplace_back(label, &target);
+        // The matches are stale now.
+        indexed = false;
+        query.clear();
+        history.clear();
+        invalidate_display();
+    }
+
+
+    const std::string&
+    search_item::get_query()
+        const noexcept
+    {
+        return query;
+    }
+
+
+    std::size_t
+    search_item::get_num_matches()
+        const noexcept
+    {
+        if (!indexed)
+            return entries.size();
+        return matches().size();
+    }
+
+
+    void
+    search_item::get_display(char* buf,
+                             std::size_t size)
+        const
+    {
+        if (query.empty())
+            std::snprintf(buf, size, "%zu items", entries.size());
+        else
+            std::snprintf(buf, size, "\"%s\": %zu matches",
+                          query.c_str(), get_num_matches());
+    }
+
+
+    void
+    search_item::get_focused_display(char* buf,
+                                     std::size_t size)
+        const
+    {
+        switch (state) {
+
+        case state_t::typing:
+            {
+                const char* shown = "";
+                char tmp[2] = {};
+                if (!alphabet.empty()) {
+                    tmp[0] = alphabet[candidate];
+                    shown = tmp[0] == ' ' ? "␣" : tmp;
+                }
+                std::snprintf(buf, size,
+                              "%s" CAFE_GLYPH_BTN_UP_DOWN "%s (%zu)",
+                              query.c_str(), shown, matches().size());
+                break;
+            }
+
+        case state_t::browsing:
+            if (auto match = current_match()) {
+                char value[80];
+                match->target->render_display(value, sizeof value, false);
+                std::snprintf(buf, size,
+                              CAFE_GLYPH_BTN_LEFT " %zu/%zu %s: %s " CAFE_GLYPH_BTN_RIGHT,
+                              current + 1, matches().size(),
+                              match->label.c_str(), value);
+            } else
+                std::snprintf(buf, size, "no matches");
+            break;
+
+        case state_t::editing:
+            if (auto match = current_match()) {
+                char value[80];
+                match->target->render_display(value, sizeof value, true);
+                std::snprintf(buf, size, "%s: %s",
+                              match->label.c_str(), value);
+                break;
+            }
+            [[fallthrough]];
+
+        case state_t::idle:
+            get_display(buf, size);
+            break;
+
+        }
+    }
+
+
+    void
+    search_item::on_focus_changed()
+    {
+        if (has_focus()) {
+            if (!indexed)
+                build_index();
+            state = state_t::typing;
+        } else
+            state = state_t::idle;
+    }
+
+
+    void
+    search_item::restore_default()
+    {
+        query.clear();
+        if (indexed) {
+            history.resize(1);
+            current = 0;
+            update_alphabet();
+        }
+    }
+
+
+    void
+    search_item::on_close()
+    {
+        state = state_t::idle;
+    }
+
+
+    focus_status
+    search_item::on_input(const simple_pad_data& input)
+    {
+        switch (state) {
+
+        case state_t::typing:
+            return focus_status::change_input; // characters are picked with complex input
+
+        case state_t::editing:
+            return on_editing_input(input);
+
+        case state_t::browsing:
+            {
+                if (input.buttons_d & WUPS_CONFIG_BUTTON_B)
+                    return focus_status::lose;
+
+                if (input.buttons_d & WUPS_CONFIG_BUTTON_Y) {
+                    state = state_t::typing;
+                    return focus_status::change_input;
+                }
+
+                const std::size_t n = matches().size();
+                if (n > 0) {
+                    if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_LEFT))
+                        current = (current + n - 1) % n;
+                    if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_RIGHT))
+                        current = (current + 1) % n;
+                }
+
+                if (input.buttons_d & WUPS_CONFIG_BUTTON_A)
+                    if (auto target = current_target()) {
+                        target->set_focus(true);
+                        // Some items refuse focus.
+                        if (target->has_focus())
+                            state = state_t::editing;
+                    }
+
+                return focus_status::keep;
+            }
+
+        case state_t::idle:
+            break;
+
+        }
+        return focus_status::lose;
+    }
+
+
+    focus_status
+    search_item::on_input(const complex_pad_data& input)
+    {
+        if (state == state_t::editing)
+            return on_editing_input(input);
+
+        if (state != state_t::typing)
+            return focus_status::change_input;
+
+        const unsigned keys = read_keys(input);
+
+        if (!alphabet.empty()) {
+            if (keys & key_next)
+                candidate = (candidate + 1) % alphabet.size();
+            if (keys & key_prev)
+                candidate = (candidate + alphabet.size() - 1) % alphabet.size();
+            if (keys & key_add)
+                push_char(alphabet[candidate]);
+        }
+
+        if (keys & key_erase) {
+            if (query.empty())
+                return focus_status::lose;
+            pop_char();
+        }
+
+        if (keys & key_done) {
+            state = state_t::browsing;
+            return focus_status::change_input;
+        }
+
+        return focus_status::keep;
+    }
+
+
+    void
+    search_item::build_index()
+    {
+        std::vector<std::uint32_t> all(entries.size());
+        for (std::size_t i = 0; i < all.size(); ++i)
+            all[i] = i;
+        history.clear();
+        history.push_back(std::move(all));
+        query.clear();
+        current = 0;
+        indexed = true;
+        update_alphabet();
+    }
+
+
+    const std::vector<std::uint32_t>&
+    search_item::matches()
+        const noexcept
+    {
+        return history.back();
+    }
+
+
+    const search_item::entry*
+    search_item::current_match()
+        const noexcept
+    {
+        if (!indexed || current >= matches().size())
+            return nullptr;
+        return &entries[matches()[current]];
+    }
+
+
+    item*
+    search_item::current_target()
+        const noexcept
+    {
+        auto match = current_match();
+        return match ? match->target : nullptr;
+    }
+
+
+    void
+    search_item::push_char(char c)
+    {
+        query += c;
+        std::vector<std::uint32_t> next;
+        for (auto idx : matches()) {
+            const std::string& label = entries[idx].label;
+            bool found;
+            if (mode == match_mode::prefix)
+                found = label.size() >= query.size() && to_lower(label[query.size() - 1]) == c;
+            else
+                found = find_nocase(label, query) != std::string::npos;
+            if (found)
+                next.push_back(idx);
+        }
+        history.push_back(std::move(next));
+        current = 0;
+        update_alphabet();
+    }
+
+
+    void
+    search_item::pop_char()
+    {
+        query.pop_back();
+        history.pop_back();
+        current = 0;
+        update_alphabet();
+    }
+
+
+    void
+    search_item::update_alphabet()
+    {
+        // Only offer characters that leave at least one match.
+        std::array<bool, 128> seen{};
+        for (auto idx : matches()) {
+            const std::string& label = entries[idx].label;
+            if (mode == match_mode::prefix) {
+                if (label.size() > query.size())
+                    mark(seen, to_lower(label[query.size()]));
+            } else {
+                for (auto pos = find_nocase(label, query);
+                     pos != std::string::npos && pos + query.size() < label.size();
+                     pos = find_nocase(label, query, pos + 1))
+                    mark(seen, to_lower(label[pos + query.size()]));
+            }
+        }
+
+        const char old = alphabet.empty() ? 'a' : alphabet[candidate];
+        alphabet.clear();
+        candidate = 0;
+        for (char c = ' '; c <= '~'; ++c)
+            if (seen[c]) {
+                if (c <= old)
+                    candidate = alphabet.size();
+                alphabet += c;
+            }
+    }
+
+
+    focus_status
+    search_item::on_editing_input(const simple_pad_data& input)
+    {
+        auto target = current_target();
+        if (!target) {
+            state = state_t::browsing;
+            return focus_status::keep;
+        }
+
+        auto res = target->on_input(input);
+        target->invalidate_display();
+        switch (res) {
+        case focus_status::lose:
+            target->set_focus(false);
+            state = state_t::browsing;
+            break;
+        case focus_status::keep:
+            break;
+        case focus_status::change_input:
+            target->set_input_mode(input_mode::complex);
+            return focus_status::change_input;
+        }
+        return focus_status::keep;
+    }
+
+
+    focus_status
+    search_item::on_editing_input(const complex_pad_data& input)
+    {
+        auto target = current_target();
+        if (!target) {
+            state = state_t::browsing;
+            return focus_status::change_input;
+        }
+
+        auto res = target->on_input(input);
+        target->invalidate_display();
+        switch (res) {
+        case focus_status::lose:
+            target->set_focus(false);
+            state = state_t::browsing;
+            return focus_status::change_input;
+        case focus_status::keep:
+            break;
+        case focus_status::change_input:
+            target->set_input_mode(input_mode::simple);
+            return focus_status::change_input;
+        }
+        return focus_status::keep;
+    }
+
+} // namespace wups::config
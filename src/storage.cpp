@@ -6,84 +6,239 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <algorithm>            // erase()
+#include <chrono>
+#include <mutex>
+#include <utility>              // move()
+#include <vector>
+
 #include <wups/storage.h>
 
 #include "wupsxx/storage.hpp"
 
+#include "wupsxx/logger.hpp"
+#include "wupsxx/storage_mirror.hpp"
+#include "wupsxx/storage_stats.hpp"
+
 
 namespace wups::storage {
 
 
-    template<>
-    std::expected<utils::color, storage_error>
-    load<utils::color>(const std::string& key)
+    namespace {
+
+        std::mutex cache_mutex;
+
+
+        // Note: function-local static, because cached<> entries are often globals.
+        std::vector<detail::cache_entry*>&
+        get_cache_entries()
+        {
+            static std::vector<detail::cache_entry*> entries;
+            return entries;
+        }
+
+    } // namespace
+
+
+    namespace {
+
+        std::expected<void, storage_error>
+        save_storage()
+        {
+            auto status = WUPSStorageAPI::SaveStorage();
+            if (status != WUPS_STORAGE_ERROR_SUCCESS) {
+                detail::count_failure(status);
+                return std::unexpected{storage_error{"error saving storage", status}};
+            }
+
+            // Only a successful save becomes the last good copy.
+            return detail::update_mirrors();
+        }
+
+
+        std::expected<void, storage_error>
+        save_now()
+        {
+            std::lock_guard storage_guard{detail::storage_mutex()};
+            {
+                std::lock_guard guard{cache_mutex};
+                for (auto entry : get_cache_entries()) {
+                    auto res = entry->try_flush();
+                    if (!res)
+                        return res;
+                }
+            }
+            return save_storage();
+        }
+
+
+        std::expected<void, storage_error>
+        save_snapshots(const std::vector<detail::store_snapshot>& snapshots)
+        {
+            std::lock_guard guard{detail::storage_mutex()};
+            for (auto& snapshot : snapshots) {
+                auto res = snapshot();
+                if (!res)
+                    return res;
+            }
+            return save_storage();
+        }
+
+
+        std::expected<void, storage_error>
+        reload_now()
+        {
+            std::lock_guard storage_guard{detail::storage_mutex()};
+            auto status = WUPSStorageAPI::ForceReloadStorage();
+            // Note: old handles are not valid anymore, even if the reload failed.
+            detail::invalidate_groups();
+            std::expected<std::size_t, storage_error> restored;
+            if (status == WUPS_STORAGE_ERROR_SUCCESS)
+                restored = detail::verify_mirrors();
+            else {
+                detail::count_failure(status);
+                // The config file is likely corrupted, rebuild it from the mirrors.
+                restored = detail::restore_mirrors();
+                if (restored && !*restored)
+                    return std::unexpected{storage_error{"error reloading storage", status}};
+                if (restored)
+                    logger::printf("Config could not be reloaded, restored %zu keys from mirrors\n",
+                                   *restored);
+            }
+            if (!restored)
+                return std::unexpected{std::move(restored.error())};
+            if (*restored) {
+                // Write the restored keys back, so the config file is good again.
+                auto res = save_storage();
+                if (!res)
+                    return res;
+            }
+
+            std::lock_guard guard{cache_mutex};
+            for (auto entry : get_cache_entries())
+                entry->invalidate();
+            return {};
+        }
+
+
+        std::chrono::microseconds
+        elapsed_since(std::chrono::steady_clock::time_point start)
+        {
+            using namespace std::chrono;
+            return duration_cast<microseconds>(steady_clock::now() - start);
+        }
+
+    } // namespace
+
+
+    std::expected<void, storage_error>
+    try_save()
     {
-        auto res = load<std::string>(key);
-        if (!res)
-            return std::unexpected{res.error()};
-        return utils::color{*res};
+        if (!stats::enabled())
+            return save_now();
+        auto start = std::chrono::steady_clock::now();
+        auto res = save_now();
+        detail::count_save(elapsed_since(start));
+        return res;
     }
 
 
-    template<>
-    std::expected<std::filesystem::path, storage_error>
-    load<std::filesystem::path>(const std::string& key)
+    void
+    save()
     {
-        auto res = load<std::string>(key);
+        auto res = try_save();
         if (!res)
-            return std::unexpected{res.error()};
-        return std::filesystem::path{*res};
+            detail::raise(res.error());
     }
 
 
-    template<>
-    std::expected<utils::button_combo, storage_error>
-    load<utils::button_combo>(const std::string& key)
-    {
-        auto res = load<std::string>(key);
-        if (!res)
-            return std::unexpected{res.error()};
-        return utils::button_combo{*res};
-    }
+    namespace detail {
 
+        std::vector<store_snapshot>
+        take_snapshots()
+        {
+            std::vector<store_snapshot> snapshots;
+            std::lock_guard guard{cache_mutex};
+            for (auto entry : get_cache_entries())
+                if (auto snapshot = entry->take_snapshot())
+                    snapshots.push_back(std::move(snapshot));
+            return snapshots;
+        }
 
-    void
-    store(const std::string& key, const utils::color& c)
-    {
-        store<std::string>(key, to_string(c));
-    }
 
+        std::expected<void, storage_error>
+        try_save_snapshots(const std::vector<store_snapshot>& snapshots)
+        {
+            if (!stats::enabled())
+                return save_snapshots(snapshots);
+            auto start = std::chrono::steady_clock::now();
+            auto res = save_snapshots(snapshots);
+            count_save(elapsed_since(start));
+            return res;
+        }
 
-    void
-    store(const std::string& key, const std::filesystem::path& p)
-    {
-        store<std::string>(key, p);
-    }
+    } // namespace detail
 
 
-    void
-    store(const std::string& key, const utils::button_combo& bc)
+    std::expected<void, storage_error>
+    try_reload()
     {
-        store<std::string>(key, to_string(bc));
+        if (!stats::enabled())
+            return reload_now();
+        auto start = std::chrono::steady_clock::now();
+        auto res = reload_now();
+        detail::count_reload(elapsed_since(start));
+        return res;
     }
 
 
     void
-    save()
+    reload()
     {
-        auto status = WUPSStorageAPI::SaveStorage();
-        if (status != WUPS_STORAGE_ERROR_SUCCESS)
-            throw storage_error{"error saving storage", status};
+        auto res = try_reload();
+        if (!res)
+            detail::raise(res.error());
     }
 
 
-    void
-    reload()
-    {
-        auto status = WUPSStorageAPI::ForceReloadStorage();
-        if (status != WUPS_STORAGE_ERROR_SUCCESS)
-            throw storage_error{"error reloading storage", status};
-    }
+    namespace detail {
+
+        cache_entry::cache_entry(const group& parent,
+                                 const std::string& name) :
+            name{name},
+            key{this->name},
+            parent{parent}
+        {
+            std::lock_guard guard{cache_mutex};
+            get_cache_entries().push_back(this);
+        }
+
+
+        cache_entry::~cache_entry()
+        {
+            std::lock_guard guard{cache_mutex};
+            std::erase(get_cache_entries(), this);
+        }
+
+
+        void
+        cache_entry::flush()
+        {
+            auto res = try_flush();
+            if (!res)
+                raise(res.error());
+        }
+
+
+        void
+        cache_entry::invalidate()
+            noexcept
+        {
+            loaded = false;
+            dirty = false;
+        }
+
+    } // namespace detail
 
 
 } // namespace wups::storage
@@ -6,8 +6,12 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <cstdlib>                // abort()
+
 #include "wupsxx/storage_error.hpp"
 
+#include "wupsxx/logger.hpp"
+
 
 namespace wups::storage {
 
@@ -18,4 +22,20 @@ namespace wups::storage {
         code{status}
     {}
 
+
+    namespace detail {
+
+        void
+        raise(const storage_error& e)
+        {
+#ifdef __cpp_exceptions
+            throw e;
+#else
+            logger::printf("Fatal storage error: %s\n", e.what());
+            std::abort();
+#endif
+        }
+
+    } // namespace detail
+
 }
@@ -0,0 +1,539 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <cstdint>
+#include <cstring>              // memcpy(), strnlen()
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <utility>              // move()
+
+#include <wups/storage.h>
+
+#include "wupsxx/storage_group.hpp"
+
+
+namespace wups::storage {
+
+    namespace detail {
+
+        struct group_node {
+            group_node* parent;
+            std::string name;
+            wups_storage_item handle = nullptr;
+            bool resolved = false;
+        };
+
+
+        namespace {
+
+            // Every blob starts with this header.
+            struct blob_header {
+                std::uint32_t magic;
+                std::uint32_t version;
+                std::uint32_t element_size;
+                std::uint32_t size; // of the payload, in bytes
+            };
+
+            constexpr std::uint32_t blob_magic = 0x57584231; // "WXB1"
+
+
+            std::mutex groups_mutex;
+
+            // Note: nodes are never erased, so pointers to them remain valid.
+            // Note: function-local static, because groups are often globals.
+            std::unordered_multimap<std::uint32_t, group_node>&
+            get_groups()
+            {
+                static std::unordered_multimap<std::uint32_t, group_node> groups;
+                return groups;
+            }
+
+
+            // Note: a missing sub-item is not remembered, it may be created later.
+            WUPSStorageError
+            resolve(group_node* node,
+                    bool create)
+            {
+                if (!node || node->resolved)
+                    return WUPS_STORAGE_ERROR_SUCCESS;
+
+                auto parent = node->parent;
+                auto status = resolve(parent, create);
+                if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                    return status;
+                wups_storage_item parent_handle = parent ? parent->handle : nullptr;
+
+                status = WUPSStorageAPI_GetSubItem(parent_handle,
+                                                   node->name.c_str(),
+                                                   &node->handle);
+                if (status == WUPS_STORAGE_ERROR_NOT_FOUND && create)
+                    status = WUPSStorageAPI_CreateSubItem(parent_handle,
+                                                          node->name.c_str(),
+                                                          &node->handle);
+                if (status == WUPS_STORAGE_ERROR_SUCCESS)
+                    node->resolved = true;
+                return status;
+            }
+
+
+            // After the sub-item `name` of `parent` was deleted, its node and all nodes
+            // below it must be looked up again.
+            void
+            forget_subgroup(group_node* parent,
+                            std::string_view name)
+                noexcept
+            {
+                auto is_removed = [parent, name](const group_node* n)
+                {
+                    for (; n; n = n->parent)
+                        if (n->parent == parent && n->name == name)
+                            return true;
+                    return false;
+                };
+                for (auto& [hash, node] : get_groups())
+                    if (is_removed(&node)) {
+                        node.handle = nullptr;
+                        node.resolved = false;
+                    }
+            }
+
+
+            // Note: copying it only bumps a reference count, so a missing key doesn't
+            // allocate.
+            storage_error
+            not_found_error()
+            {
+                static const storage_error error{"key not found",
+                                                 WUPS_STORAGE_ERROR_NOT_FOUND};
+                return error;
+            }
+
+        } // namespace
+
+
+        std::recursive_mutex&
+        storage_mutex()
+            noexcept
+        {
+            // Note: function-local static, because globals are loaded in constructors.
+            static std::recursive_mutex mutex;
+            return mutex;
+        }
+
+
+        storage_error
+        make_load_error(const key& k, WUPSStorageError status)
+        {
+            // Note: a missing key is expected, load_or_init() relies on it.
+            if (status == WUPS_STORAGE_ERROR_NOT_FOUND)
+                return not_found_error();
+            count_failure(status);
+            return storage_error{"error loading key \"" + std::string{k.name()} + "\"",
+                                 status};
+        }
+
+
+        storage_error
+        make_store_error(const key& k, WUPSStorageError status)
+        {
+            if (status == WUPS_STORAGE_ERROR_NOT_FOUND)
+                return not_found_error();
+            count_failure(status);
+            return storage_error{"error storing key \"" + std::string{k.name()} + "\"",
+                                 status};
+        }
+
+
+        storage_error
+        make_remove_error(const key& k, WUPSStorageError status)
+        {
+            if (status == WUPS_STORAGE_ERROR_NOT_FOUND)
+                return not_found_error();
+            count_failure(status);
+            return storage_error{"error removing key \"" + std::string{k.name()} + "\"",
+                                 status};
+        }
+
+
+        std::expected<std::vector<std::byte>, WUPSStorageError>
+        read_raw_item(wups_storage_item parent,
+                      const std::string& name,
+                      WUPSStorageItemType type)
+        {
+            std::uint32_t size = 0;
+            switch (type) {
+            case WUPS_STORAGE_ITEM_BOOL:
+                size = sizeof(bool);
+                break;
+            case WUPS_STORAGE_ITEM_S32:
+            case WUPS_STORAGE_ITEM_U32:
+            case WUPS_STORAGE_ITEM_FLOAT:
+                size = 4;
+                break;
+            case WUPS_STORAGE_ITEM_S64:
+            case WUPS_STORAGE_ITEM_U64:
+            case WUPS_STORAGE_ITEM_DOUBLE:
+                size = 8;
+                break;
+            case WUPS_STORAGE_ITEM_STRING:
+            case WUPS_STORAGE_ITEM_BINARY:
+                {
+                    auto status = WUPSStorageAPI_GetItemSize(parent,
+                                                             name.c_str(),
+                                                             type,
+                                                             &size);
+                    if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                        return std::unexpected{status};
+                }
+                break;
+            default:
+                return std::unexpected{WUPS_STORAGE_ERROR_INVALID_ARGUMENT};
+            }
+
+            std::vector<std::byte> buf(size);
+            std::uint32_t read_size = 0;
+            auto status = WUPSStorageAPI_GetItem(parent,
+                                                 name.c_str(),
+                                                 type,
+                                                 buf.data(),
+                                                 buf.size(),
+                                                 &read_size);
+            if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                return std::unexpected{status};
+            if (type == WUPS_STORAGE_ITEM_STRING) // drop the null terminator
+                buf.resize(strnlen(reinterpret_cast<const char*>(buf.data()), size));
+            else if (type == WUPS_STORAGE_ITEM_BINARY)
+                buf.resize(read_size);
+            return buf;
+        }
+
+
+        void
+        invalidate_groups()
+            noexcept
+        {
+            std::lock_guard guard{groups_mutex};
+            for (auto& [hash, node] : get_groups()) {
+                node.handle = nullptr;
+                node.resolved = false;
+            }
+        }
+
+    } // namespace detail
+
+
+    group::group(const group& parent,
+                 const key& k)
+    {
+        std::lock_guard guard{detail::groups_mutex};
+        auto& groups = detail::get_groups();
+        auto [first, last] = groups.equal_range(k.hash());
+        for (auto it = first; it != last; ++it) {
+            auto& candidate = it->second;
+            if (candidate.parent == parent.node && candidate.name == k.name()) {
+                node = &candidate;
+                return;
+            }
+        }
+        auto it = groups.emplace(k.hash(),
+                                 detail::group_node{
+                                     .parent = parent.node,
+                                     .name = std::string{k.name()}
+                                 });
+        node = &it->second;
+    }
+
+
+    std::expected<wups_storage_item, storage_error>
+    group::get_handle(bool create)
+        const
+    {
+        if (!node)
+            return nullptr;
+
+        std::lock_guard storage_guard{detail::storage_mutex()};
+        std::lock_guard guard{detail::groups_mutex};
+        auto status = detail::resolve(node, create);
+        if (status == WUPS_STORAGE_ERROR_NOT_FOUND)
+            return std::unexpected{detail::not_found_error()};
+        if (status != WUPS_STORAGE_ERROR_SUCCESS) {
+            detail::count_failure(status);
+            return std::unexpected{storage_error{"error opening group \"" + node->name + "\"",
+                                                 status}};
+        }
+        return node->handle;
+    }
+
+
+    namespace {
+
+        // Load a string item into `buf`, without allocating.
+        std::expected<std::string_view, WUPSStorageError>
+        load_chars(wups_storage_item parent,
+                   const key& k,
+                   std::span<char> buf)
+        {
+            std::uint32_t size = 0;
+            auto status = WUPSStorageAPI_GetItem(parent,
+                                                 k.name().data(),
+                                                 WUPS_STORAGE_ITEM_STRING,
+                                                 buf.data(),
+                                                 buf.size(),
+                                                 &size);
+            if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                return std::unexpected{status};
+            return std::string_view{buf.data(), strnlen(buf.data(), buf.size())};
+        }
+
+
+        // Parse a string item; it only goes through a std::string if it doesn't fit
+        // in N chars.
+        template<typename T,
+                 std::size_t N>
+        std::expected<T, storage_error>
+        load_parsed(const group& g,
+                    const key& k)
+        {
+            std::lock_guard guard{detail::storage_mutex()};
+            auto parent = g.get_handle();
+            if (!parent)
+                return std::unexpected{parent.error()};
+
+            char buf[N];
+            std::string fallback;
+            auto str = load_chars(*parent, k, buf);
+            if (!str && str.error() == WUPS_STORAGE_ERROR_BUFFER_TOO_SMALL) {
+                auto res = g.load<std::string>(k);
+                if (!res)
+                    return std::unexpected{res.error()};
+                fallback = std::move(*res);
+                str = fallback;
+            } else if (!str)
+                return std::unexpected{detail::make_load_error(k, str.error())};
+            else {
+                detail::track_load(g, k, WUPS_STORAGE_ITEM_STRING);
+                detail::count_load(WUPS_STORAGE_ITEM_STRING);
+            }
+
+            auto value = utils::parse<T>(*str);
+            if (!value) {
+                detail::count_failure(WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE);
+                return std::unexpected{storage_error{"error parsing key \""
+                                                     + std::string{k.name()} + "\": "
+                                                     + utils::message(value.error().code),
+                                                     WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE}};
+            }
+            return std::move(*value);
+        }
+
+    } // namespace
+
+
+    template<>
+    std::expected<utils::color, storage_error>
+    group::load<utils::color>(const key& k)
+        const
+    {
+        return load_parsed<utils::color, 16>(*this, k);
+    }
+
+
+    template<>
+    std::expected<std::filesystem::path, storage_error>
+    group::load<std::filesystem::path>(const key& k)
+        const
+    {
+        auto res = load<std::string>(k);
+        if (!res)
+            return std::unexpected{res.error()};
+        return std::filesystem::path{*res};
+    }
+
+
+    template<>
+    std::expected<utils::button_combo, storage_error>
+    group::load<utils::button_combo>(const key& k)
+        const
+    {
+        return load_parsed<utils::button_combo, 256>(*this, k);
+    }
+
+
+    std::expected<void, storage_error>
+    group::try_store(const key& k, const utils::color& c)
+    {
+        return try_store<std::string>(k, to_string(c));
+    }
+
+
+    std::expected<void, storage_error>
+    group::try_store(const key& k, const std::filesystem::path& p)
+    {
+        return try_store<std::string>(k, p);
+    }
+
+
+    std::expected<void, storage_error>
+    group::try_store(const key& k, const utils::button_combo& bc)
+    {
+        return try_store<std::string>(k, to_string(bc));
+    }
+
+
+
+    std::expected<std::vector<std::byte>, storage_error>
+    group::load_bytes(const key& k,
+                      std::uint32_t version,
+                      std::uint32_t element_size)
+        const
+    {
+        std::lock_guard guard{detail::storage_mutex()};
+        auto parent = get_handle();
+        if (!parent)
+            return std::unexpected{parent.error()};
+
+        std::uint32_t total_size = 0;
+        auto status = WUPSStorageAPI_GetItemSize(*parent,
+                                                 k.name().data(),
+                                                 WUPS_STORAGE_ITEM_BINARY,
+                                                 &total_size);
+        if (status != WUPS_STORAGE_ERROR_SUCCESS)
+            return std::unexpected{detail::make_load_error(k, status)};
+        if (total_size < sizeof(detail::blob_header))
+            return std::unexpected{detail::make_load_error(k,
+                                                           WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE)};
+
+        std::vector<std::byte> buf(total_size);
+        std::uint32_t read_size = 0;
+        status = WUPSStorageAPI_GetItem(*parent,
+                                        k.name().data(),
+                                        WUPS_STORAGE_ITEM_BINARY,
+                                        buf.data(),
+                                        buf.size(),
+                                        &read_size);
+        if (status != WUPS_STORAGE_ERROR_SUCCESS)
+            return std::unexpected{detail::make_load_error(k, status)};
+
+        detail::blob_header header;
+        std::memcpy(&header, buf.data(), sizeof header);
+        if (header.magic != detail::blob_magic
+            || header.version != version
+            || header.element_size != element_size
+            || header.size != read_size - sizeof header
+            || header.size % element_size != 0)
+            return std::unexpected{detail::make_load_error(k,
+                                                           WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE)};
+
+        detail::track_load(*this, k, WUPS_STORAGE_ITEM_BINARY);
+        detail::count_load(WUPS_STORAGE_ITEM_BINARY);
+
+        buf.erase(buf.begin(), buf.begin() + sizeof header);
+        buf.resize(header.size);
+        return buf;
+    }
+
+
+    std::expected<void, storage_error>
+    group::try_remove(const key& k)
+    {
+        std::unique_lock lock{detail::storage_mutex()};
+        auto parent = get_handle();
+        if (!parent) {
+            // Nothing to remove from a group that doesn't exist.
+            if (parent.error().code == WUPS_STORAGE_ERROR_NOT_FOUND)
+                return {};
+            return std::unexpected{parent.error()};
+        }
+        detail::journal_change(*this, *parent, k, detail::no_item_type);
+        auto status = WUPSStorageAPI_DeleteItem(*parent, k.name().data());
+        if (status == WUPS_STORAGE_ERROR_NOT_FOUND)
+            return {};
+        if (status != WUPS_STORAGE_ERROR_SUCCESS)
+            return std::unexpected{detail::make_remove_error(k, status)};
+        {
+            // If it was a sub-item, its handle (and its children's) is gone.
+            std::lock_guard groups_guard{detail::groups_mutex};
+            detail::forget_subgroup(node, k.name());
+        }
+        detail::track_remove(*this, k);
+        // Note: notify outside the storage lock, so observers don't contend with it.
+        lock.unlock();
+        notify(*this, k);
+        return {};
+    }
+
+
+    void
+    group::remove(const key& k)
+    {
+        auto res = try_remove(k);
+        if (!res)
+            detail::raise(res.error());
+    }
+
+
+    std::expected<void, storage_error>
+    group::try_store(const key& k, std::span<const std::byte> data)
+    {
+        return try_store_bytes(k, data);
+    }
+
+
+    std::expected<void, storage_error>
+    group::try_store_bytes(const key& k,
+                           std::span<const std::byte> data,
+                           std::uint32_t version,
+                           std::uint32_t element_size)
+    {
+        std::unique_lock lock{detail::storage_mutex()};
+        auto parent = get_handle(true);
+        if (!parent)
+            return std::unexpected{parent.error()};
+
+        const detail::blob_header header{
+            .magic = detail::blob_magic,
+            .version = version,
+            .element_size = element_size,
+            .size = static_cast<std::uint32_t>(data.size())
+        };
+        std::vector<std::byte> buf(sizeof header + data.size());
+        std::memcpy(buf.data(), &header, sizeof header);
+        if (!data.empty())
+            std::memcpy(buf.data() + sizeof header, data.data(), data.size());
+
+        detail::journal_change(*this, *parent, k, WUPS_STORAGE_ITEM_BINARY);
+        auto status = WUPSStorageAPI_StoreItem(*parent,
+                                               k.name().data(),
+                                               WUPS_STORAGE_ITEM_BINARY,
+                                               buf.data(),
+                                               buf.size());
+        if (status != WUPS_STORAGE_ERROR_SUCCESS)
+            return std::unexpected{detail::make_store_error(k, status)};
+        detail::track_store(*this, k, WUPS_STORAGE_ITEM_BINARY);
+        detail::count_store(WUPS_STORAGE_ITEM_BINARY, buf.size());
+        // Note: notify outside the storage lock, so observers don't contend with it.
+        lock.unlock();
+        notify(*this, k);
+        return {};
+    }
+
+
+    void
+    group::store_bytes(const key& k,
+                       std::span<const std::byte> data,
+                       std::uint32_t version,
+                       std::uint32_t element_size)
+    {
+        auto res = try_store_bytes(k, data, version, element_size);
+        if (!res)
+            detail::raise(res.error());
+    }
+
+} // namespace wups::storage
@@ -0,0 +1,232 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // any_of(), find()
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>              // exchange(), move()
+#include <vector>
+
+#include "wupsxx/storage_migration.hpp"
+
+#include "wupsxx/storage.hpp"
+
+
+namespace wups::storage {
+
+    namespace detail {
+
+        namespace {
+
+            // The value a key had before the running migration first changed it.
+            struct journal_entry {
+                group parent;
+                std::string name;
+                // no_item_type if the key didn't exist.
+                WUPSStorageItemType type;
+                std::vector<std::byte> data;
+            };
+
+
+            // Note: only the thread running migrate() records its changes.
+            thread_local std::vector<journal_entry>* journal = nullptr;
+
+
+            // Tried in order when the type of the old value is not known.
+            constexpr WUPSStorageItemType probe_types[] = {
+                WUPS_STORAGE_ITEM_STRING,
+                WUPS_STORAGE_ITEM_BINARY,
+                WUPS_STORAGE_ITEM_S32,
+                WUPS_STORAGE_ITEM_S64,
+                WUPS_STORAGE_ITEM_U32,
+                WUPS_STORAGE_ITEM_U64,
+                WUPS_STORAGE_ITEM_FLOAT,
+                WUPS_STORAGE_ITEM_DOUBLE,
+                WUPS_STORAGE_ITEM_BOOL,
+            };
+
+        } // namespace
+
+
+        void
+        journal_change(const group& parent,
+                       wups_storage_item handle,
+                       const key& k,
+                       WUPSStorageItemType type)
+        {
+            if (!journal)
+                return;
+            const std::string_view name = k.name();
+            if (std::ranges::any_of(*journal, [&](const journal_entry& e)
+                                    {
+                                        return e.name == name && e.parent == parent;
+                                    }))
+                return;
+
+            // Sub-items can't be copied, so they can't be restored either.
+            wups_storage_item sub_item;
+            if (WUPSStorageAPI_GetSubItem(handle, name.data(), &sub_item)
+                == WUPS_STORAGE_ERROR_SUCCESS)
+                return;
+
+            journal_entry entry{parent, std::string{name}, no_item_type, {}};
+            auto try_type = [&entry, handle](WUPSStorageItemType t)
+            {
+                auto data = read_raw_item(handle, entry.name, t);
+                if (!data)
+                    return false;
+                entry.type = t;
+                entry.data = std::move(*data);
+                return true;
+            };
+            if (type == no_item_type || !try_type(type))
+                for (auto t : probe_types)
+                    if (t != type && try_type(t))
+                        break;
+            journal->push_back(std::move(entry));
+        }
+
+    } // namespace detail
+
+
+    namespace {
+
+        // Journal the changes made on this thread while it's alive.
+        class journal_scope {
+
+            std::vector<detail::journal_entry>* previous;
+
+        public:
+
+            explicit
+            journal_scope(std::vector<detail::journal_entry>& journal) noexcept :
+                previous{std::exchange(detail::journal, &journal)}
+            {}
+
+            journal_scope(const journal_scope&) = delete;
+
+            ~journal_scope()
+            {
+                detail::journal = previous;
+            }
+
+        };
+
+
+        // Put back the keys changed by the failed migration; other changes, saved or
+        // not, are kept.
+        migration_result
+        roll_back(const std::vector<detail::journal_entry>& journal,
+                  storage_error error)
+        {
+            {
+                std::lock_guard guard{detail::storage_mutex()};
+                for (auto& e : journal | std::views::reverse) {
+                    auto handle = e.parent.get_handle(true);
+                    if (!handle)
+                        continue;
+                    // Errors are ignored, the original error is more relevant.
+                    const key k{e.name};
+                    if (e.type == detail::no_item_type) {
+                        (void) WUPSStorageAPI_DeleteItem(*handle, e.name.c_str());
+                        detail::track_remove(e.parent, k);
+                    } else {
+                        (void) WUPSStorageAPI_StoreItem(*handle,
+                                                        e.name.c_str(),
+                                                        e.type,
+                                                        const_cast<std::byte*>(e.data.data()),
+                                                        e.data.size());
+                        detail::track_store(e.parent, k, e.type);
+                    }
+                }
+            }
+            for (auto& e : journal)
+                notify(e.parent, key{e.name});
+            return std::unexpected{std::move(error)};
+        }
+
+
+        // User steps may still throw, when exceptions are enabled.
+        migration_result
+        run_step(const migration_step& step,
+                 group& parent)
+        {
+#ifdef __cpp_exceptions
+            try {
+                return step.apply(parent);
+            }
+            catch (storage_error& e) {
+                return std::unexpected{std::move(e)};
+            }
+            catch (std::exception& e) {
+                return std::unexpected{storage_error{std::string{"migration failed: "}
+                                                     + e.what(),
+                                                     WUPS_STORAGE_ERROR_UNKNOWN_ERROR}};
+            }
+#else
+            return step.apply(parent);
+#endif
+        }
+
+    } // namespace
+
+
+    migration_result
+    migrate(std::uint32_t target,
+            std::span<const migration_step> steps,
+            group parent,
+            const key& version_key)
+    {
+        std::uint32_t version = 0;
+        auto stored_version = parent.load<std::uint32_t>(version_key);
+        if (stored_version)
+            version = *stored_version;
+        else if (stored_version.error().code != WUPS_STORAGE_ERROR_NOT_FOUND)
+            return std::unexpected{std::move(stored_version.error())};
+
+        if (version == target)
+            return {};
+
+        if (version > target)
+            return std::unexpected{storage_error{"storage version "
+                                                 + std::to_string(version)
+                                                 + " is newer than "
+                                                 + std::to_string(target),
+                                                 WUPS_STORAGE_ERROR_UNEXPECTED_DATA_TYPE}};
+
+        std::vector<detail::journal_entry> journal;
+        {
+            journal_scope scope{journal};
+            for (; version < target; ++version) {
+                auto step = std::ranges::find(steps, version, &migration_step::from);
+                if (step == steps.end() || !step->apply)
+                    return roll_back(journal,
+                                     storage_error{"no migration step from version "
+                                                   + std::to_string(version),
+                                                   WUPS_STORAGE_ERROR_NOT_FOUND});
+                auto res = run_step(*step, parent);
+                if (!res)
+                    return roll_back(journal, std::move(res.error()));
+            }
+            auto res = parent.try_store(version_key, target);
+            if (!res)
+                return roll_back(journal, std::move(res.error()));
+        }
+
+        // Note: the save also flushes cached<> entries, those are not journaled.
+        auto res = try_save();
+        if (!res)
+            return roll_back(journal, std::move(res.error()));
+        return {};
+    }
+
+} // namespace wups::storage
@@ -0,0 +1,710 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // erase()
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>              // memcpy()
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <wups/storage.h>
+
+#include "wupsxx/storage_mirror.hpp"
+
+#include "wupsxx/logger.hpp"
+
+
+namespace wups::storage {
+
+    namespace detail {
+
+        struct mirror_item {
+            WUPSStorageItemType type;
+            std::vector<std::byte> data;
+            std::uint32_t hash;
+        };
+
+
+        struct mirror_state {
+
+            mirror* owner;
+            group primary;
+            std::filesystem::path filename;
+
+            std::mutex mut;
+            bool loaded = false;
+            // The file doesn't match `items`, and must be written again in full.
+            bool rewrite = false;
+            // An update failed, so the mirror may be older than the saved config; it's not
+            // used to restore anything until an update succeeds.
+            bool invalid = false;
+
+            std::map<std::string, mirror_item, std::less<>> items;
+
+            // Keys that must be read again from the primary group, with their type;
+            // no_item_type for removed keys.
+            std::map<std::string, WUPSStorageItemType, std::less<>> dirty;
+
+            // Wrapping sum of the item hashes, so it can be updated one key at a time.
+            std::uint32_t checksum = 0;
+
+            // Bytes taken by the records of `items`, and by the whole file.
+            std::size_t items_size = 0;
+            std::size_t file_size = 0;
+
+        };
+
+
+        namespace {
+
+            // File layout: a file_header, followed by `count` records, followed by any number
+            // of update blocks. Each block is a block_header, followed by `count` records.
+            // Each record is a record_header, the key name and the item data; in blocks, a
+            // record with no_item_type marks a removed key.
+            //
+            // The checksums are the wrapping sum of the hashes of the records they cover.
+
+            struct file_header {
+                std::uint32_t magic;
+                std::uint32_t version;
+                std::uint32_t count;
+                std::uint32_t checksum;
+            };
+
+            struct block_header {
+                std::uint32_t magic;
+                std::uint32_t count;
+                std::uint32_t checksum;
+            };
+
+            struct record_header {
+                std::uint32_t type;
+                std::uint32_t name_size;
+                std::uint32_t data_size;
+            };
+
+            constexpr std::uint32_t file_magic = 0x57584D31; // "WXM1"
+            constexpr std::uint32_t file_version = 2;
+            constexpr std::uint32_t block_magic = 0x57584D55; // "WXMU"
+
+
+            std::mutex mirrors_mutex;
+
+            // Checked before taking the mutex, so tracking is cheap when there are no
+            // mirrors.
+            std::atomic_uint num_mirrors = 0;
+
+            // Note: function-local static, because mirrors are often globals.
+            std::vector<mirror_state*>&
+            get_mirrors()
+            {
+                static std::vector<mirror_state*> mirrors;
+                return mirrors;
+            }
+
+
+            std::uint32_t
+            fnv1a(std::uint32_t h,
+                  std::span<const std::byte> bytes)
+                noexcept
+            {
+                for (auto b : bytes) {
+                    h ^= std::to_integer<std::uint32_t>(b);
+                    h *= 16777619u;
+                }
+                return h;
+            }
+
+
+            std::uint32_t
+            hash_item(std::string_view name,
+                      WUPSStorageItemType type,
+                      std::span<const std::byte> data)
+                noexcept
+            {
+                std::uint32_t h = 2166136261u;
+                h = fnv1a(h, std::as_bytes(std::span{name.data(), name.size() + 1}));
+                h = fnv1a(h, std::as_bytes(std::span{&type, 1}));
+                return fnv1a(h, data);
+            }
+
+
+            WUPSStorageError
+            write_item(wups_storage_item parent,
+                       const std::string& name,
+                       const mirror_item& item)
+            {
+                return WUPSStorageAPI_StoreItem(parent,
+                                                name.c_str(),
+                                                item.type,
+                                                const_cast<std::byte*>(item.data.data()),
+                                                item.data.size());
+            }
+
+
+            std::vector<std::byte>
+            read_file(const std::filesystem::path& filename)
+            {
+                std::vector<std::byte> buf;
+                std::FILE* f = std::fopen(filename.c_str(), "rb");
+                if (!f)
+                    return buf;
+                std::byte chunk[1024];
+                std::size_t n;
+                while ((n = std::fread(chunk, 1, sizeof chunk, f)) > 0)
+                    buf.insert(buf.end(), chunk, chunk + n);
+                std::fclose(f);
+                return buf;
+            }
+
+
+            std::size_t
+            record_size(std::string_view name,
+                        std::size_t data_size)
+                noexcept
+            {
+                return sizeof(record_header) + name.size() + data_size;
+            }
+
+
+            void
+            erase_item(mirror_state& st,
+                       std::string_view name)
+            {
+                auto it = st.items.find(name);
+                if (it == st.items.end())
+                    return;
+                st.checksum -= it->second.hash;
+                st.items_size -= record_size(it->first, it->second.data.size());
+                st.items.erase(it);
+            }
+
+
+            void
+            put_item(mirror_state& st,
+                     const std::string& name,
+                     WUPSStorageItemType type,
+                     std::vector<std::byte> data)
+            {
+                erase_item(st, name);
+                auto h = hash_item(name, type, data);
+                st.checksum += h;
+                st.items_size += record_size(name, data.size());
+                st.items.emplace(name, mirror_item{type, std::move(data), h});
+            }
+
+
+            void
+            clear_items(mirror_state& st)
+                noexcept
+            {
+                st.items.clear();
+                st.checksum = 0;
+                st.items_size = 0;
+            }
+
+
+            struct record {
+                std::string name;
+                WUPSStorageItemType type;
+                std::span<const std::byte> data;
+            };
+
+
+            // Consume `count` records from `buf`; returns false if they're cut short.
+            bool
+            parse_records(std::span<const std::byte>& buf,
+                          std::uint32_t count,
+                          std::vector<record>& records)
+            {
+                for (std::uint32_t i = 0; i < count; ++i) {
+                    record_header rec;
+                    if (buf.size() < sizeof rec)
+                        return false;
+                    std::memcpy(&rec, buf.data(), sizeof rec);
+                    buf = buf.subspan(sizeof rec);
+                    if (buf.size() < std::size_t{rec.name_size} + rec.data_size)
+                        return false;
+                    records.push_back(record{
+                            std::string(reinterpret_cast<const char*>(buf.data()),
+                                        rec.name_size),
+                            rec.type,
+                            buf.subspan(rec.name_size, rec.data_size)
+                        });
+                    buf = buf.subspan(std::size_t{rec.name_size} + rec.data_size);
+                }
+                return true;
+            }
+
+
+            std::uint32_t
+            checksum_of(const std::vector<record>& records)
+                noexcept
+            {
+                std::uint32_t sum = 0;
+                for (auto& r : records)
+                    sum += hash_item(r.name, r.type, r.data);
+                return sum;
+            }
+
+
+            // Returns false if the contents are not a valid mirror file.
+            bool
+            parse(std::span<const std::byte> buf,
+                  mirror_state& st)
+            {
+                clear_items(st);
+                const std::size_t total_size = buf.size();
+
+                file_header header;
+                if (buf.size() < sizeof header)
+                    return false;
+                std::memcpy(&header, buf.data(), sizeof header);
+                buf = buf.subspan(sizeof header);
+                if (header.magic != file_magic || header.version != file_version)
+                    return false;
+
+                std::vector<record> records;
+                if (!parse_records(buf, header.count, records)
+                    || checksum_of(records) != header.checksum)
+                    return false;
+                for (auto& r : records)
+                    if (r.type != no_item_type)
+                        put_item(st, r.name, r.type, {r.data.begin(), r.data.end()});
+
+                st.rewrite = false;
+                st.invalid = false;
+                while (!buf.empty()) {
+                    block_header block;
+                    records.clear();
+                    bool ok = buf.size() >= sizeof block;
+                    if (ok) {
+                        std::memcpy(&block, buf.data(), sizeof block);
+                        buf = buf.subspan(sizeof block);
+                        ok = block.magic == block_magic
+                            && parse_records(buf, block.count, records)
+                            && checksum_of(records) == block.checksum;
+                    }
+                    if (!ok) {
+                        // The plugin stopped while appending this block, after the config
+                        // was saved: the mirror is behind it.
+                        st.rewrite = true;
+                        st.invalid = true;
+                        break;
+                    }
+                    for (auto& r : records) {
+                        if (r.type == no_item_type)
+                            erase_item(st, r.name);
+                        else
+                            put_item(st, r.name, r.type, {r.data.begin(), r.data.end()});
+                    }
+                }
+                st.file_size = total_size;
+                return true;
+            }
+
+
+            void
+            append_record(std::vector<std::byte>& buf,
+                          std::string_view name,
+                          WUPSStorageItemType type,
+                          std::span<const std::byte> data)
+            {
+                const record_header rec{
+                    .type = type,
+                    .name_size = static_cast<std::uint32_t>(name.size()),
+                    .data_size = static_cast<std::uint32_t>(data.size())
+                };
+                auto rec_bytes = std::as_bytes(std::span{&rec, 1});
+                buf.insert(buf.end(), rec_bytes.begin(), rec_bytes.end());
+                auto name_bytes = std::as_bytes(std::span{name});
+                buf.insert(buf.end(), name_bytes.begin(), name_bytes.end());
+                buf.insert(buf.end(), data.begin(), data.end());
+            }
+
+
+            bool
+            write_all(std::FILE* f,
+                      std::span<const std::byte> buf)
+            {
+                bool ok = std::fwrite(buf.data(), 1, buf.size(), f) == buf.size();
+                ok = std::fflush(f) == 0 && ok;
+                ok = std::fclose(f) == 0 && ok;
+                return ok;
+            }
+
+
+            // Replace the file with one that holds only `items`.
+            bool
+            write_full(mirror_state& st)
+            {
+                auto tmp_filename = st.filename;
+                tmp_filename += ".tmp";
+
+                const file_header header{
+                    .magic = file_magic,
+                    .version = file_version,
+                    .count = static_cast<std::uint32_t>(st.items.size()),
+                    .checksum = st.checksum
+                };
+                std::vector<std::byte> buf;
+                buf.reserve(sizeof header + st.items_size);
+                auto header_bytes = std::as_bytes(std::span{&header, 1});
+                buf.insert(buf.end(), header_bytes.begin(), header_bytes.end());
+                for (auto& [name, item] : st.items)
+                    append_record(buf, name, item.type, item.data);
+
+                std::FILE* f = std::fopen(tmp_filename.c_str(), "wb");
+                if (!f || !write_all(f, buf))
+                    return false;
+
+                std::error_code ec;
+                std::filesystem::rename(tmp_filename, st.filename, ec);
+                if (ec) {
+                    // Some filesystems (like FAT) can't rename over an existing file.
+                    // If we crash in between, the ".tmp" file is still found by load().
+                    std::filesystem::remove(st.filename, ec);
+                    std::filesystem::rename(tmp_filename, st.filename, ec);
+                }
+                if (ec)
+                    return false;
+                st.file_size = buf.size();
+                st.rewrite = false;
+                return true;
+            }
+
+
+            // Append a block with the records of the keys in `changed`; the ones that are
+            // not in `items` anymore are written as removed.
+            bool
+            write_block(mirror_state& st,
+                        const std::vector<std::string>& changed)
+            {
+                std::vector<std::byte> buf(sizeof(block_header));
+                std::uint32_t sum = 0;
+                for (auto& name : changed) {
+                    auto it = st.items.find(name);
+                    if (it != st.items.end()) {
+                        append_record(buf, name, it->second.type, it->second.data);
+                        sum += it->second.hash;
+                    } else {
+                        append_record(buf, name, no_item_type, {});
+                        sum += hash_item(name, no_item_type, {});
+                    }
+                }
+                const block_header block{
+                    .magic = block_magic,
+                    .count = static_cast<std::uint32_t>(changed.size()),
+                    .checksum = sum
+                };
+                std::memcpy(buf.data(), &block, sizeof block);
+
+                std::FILE* f = std::fopen(st.filename.c_str(), "ab");
+                if (!f || !write_all(f, buf))
+                    return false;
+                st.file_size += buf.size();
+                return true;
+            }
+
+
+            // Forget the file, since it may be older than the saved config now; every key
+            // is read again on the next update.
+            void
+            invalidate(mirror_state& st)
+            {
+                st.invalid = true;
+                st.rewrite = true;
+                for (auto& [name, item] : st.items)
+                    st.dirty.try_emplace(name, item.type);
+                std::error_code ec;
+                std::filesystem::remove(st.filename, ec);
+                auto tmp_filename = st.filename;
+                tmp_filename += ".tmp";
+                std::filesystem::remove(tmp_filename, ec);
+            }
+
+
+            void
+            load(mirror_state& st)
+            {
+                if (st.loaded)
+                    return;
+                st.loaded = true;
+
+                // Note: a complete ".tmp" file is newer than the file it was replacing.
+                auto tmp_filename = st.filename;
+                tmp_filename += ".tmp";
+                for (auto& filename : {tmp_filename, st.filename}) {
+                    auto buf = read_file(filename);
+                    if (buf.empty())
+                        continue;
+                    if (parse(buf, st)) {
+                        if (st.invalid)
+                            invalidate(st);
+                        if (filename == tmp_filename)
+                            st.rewrite = true;
+                        return;
+                    }
+                    logger::printf("Ignoring corrupted mirror file \"%s\"\n", filename.c_str());
+                }
+                clear_items(st);
+                st.rewrite = true;
+            }
+
+
+            template<typename F>
+            void
+            for_each_mirror(const group& parent,
+                            F&& func)
+            {
+                if (!num_mirrors)
+                    return;
+                std::lock_guard guard{mirrors_mutex};
+                for (auto st : get_mirrors())
+                    if (st->primary == parent) {
+                        std::lock_guard st_guard{st->mut};
+                        func(*st);
+                    }
+            }
+
+        } // namespace
+
+
+        void
+        track_load(const group& parent,
+                   const key& k,
+                   WUPSStorageItemType type)
+        {
+            if (type == no_item_type)
+                return;
+            for_each_mirror(parent, [&](mirror_state& st)
+            {
+                // Only new keys matter, the known ones didn't change.
+                if (!st.items.contains(k.name()) && !st.dirty.contains(k.name()))
+                    st.dirty.emplace(k.name(), type);
+            });
+        }
+
+
+        void
+        track_store(const group& parent,
+                    const key& k,
+                    WUPSStorageItemType type)
+        {
+            if (type == no_item_type)
+                return;
+            for_each_mirror(parent, [&](mirror_state& st)
+            {
+                st.dirty.insert_or_assign(std::string{k.name()}, type);
+            });
+        }
+
+
+        void
+        track_remove(const group& parent,
+                     const key& k)
+        {
+            for_each_mirror(parent, [&](mirror_state& st)
+            {
+                st.dirty.insert_or_assign(std::string{k.name()}, no_item_type);
+            });
+        }
+
+
+        std::expected<void, storage_error>
+        update_mirrors()
+        {
+            if (!num_mirrors)
+                return {};
+            std::lock_guard guard{mirrors_mutex};
+            for (auto st : get_mirrors()) {
+                auto res = st->owner->update();
+                if (!res)
+                    return res;
+            }
+            return {};
+        }
+
+
+        std::expected<std::size_t, storage_error>
+        verify_mirrors()
+        {
+            if (!num_mirrors)
+                return 0;
+            std::size_t restored = 0;
+            std::lock_guard guard{mirrors_mutex};
+            for (auto st : get_mirrors()) {
+                auto res = st->owner->verify();
+                if (!res)
+                    return res;
+                restored += *res;
+            }
+            return restored;
+        }
+
+
+        std::expected<std::size_t, storage_error>
+        restore_mirrors()
+        {
+            if (!num_mirrors)
+                return 0;
+            std::lock_guard guard{mirrors_mutex};
+            bool usable = false;
+            for (auto st : get_mirrors()) {
+                std::lock_guard st_guard{st->mut};
+                load(*st);
+                usable = usable || (!st->invalid && !st->items.empty());
+            }
+            if (!usable)
+                return 0;
+
+            // Note: nothing is wiped; only the mirrored keys are written back, everything
+            // else keeps whatever the failed reload left (usually nothing.)
+            invalidate_groups();
+            logger::printf("Restoring mirrored keys; other keys are not restored\n");
+
+            std::size_t restored = 0;
+            for (auto st : get_mirrors()) {
+                auto res = st->owner->verify();
+                if (!res)
+                    return res;
+                restored += *res;
+            }
+            return restored;
+        }
+
+    } // namespace detail
+
+
+    mirror::mirror(const group& primary,
+                   const std::filesystem::path& filename) :
+        st{std::make_unique<detail::mirror_state>()}
+    {
+        st->owner = this;
+        st->primary = primary;
+        st->filename = filename;
+
+        std::lock_guard guard{detail::mirrors_mutex};
+        detail::get_mirrors().push_back(st.get());
+        ++detail::num_mirrors;
+    }
+
+
+    mirror::~mirror()
+    {
+        std::lock_guard guard{detail::mirrors_mutex};
+        std::erase(detail::get_mirrors(), st.get());
+        --detail::num_mirrors;
+    }
+
+
+    std::expected<std::size_t, storage_error>
+    mirror::verify()
+    {
+        // Note: same order as save() and store(): storage, then this mirror.
+        std::lock_guard storage_guard{detail::storage_mutex()};
+        std::lock_guard guard{st->mut};
+        detail::load(*st);
+        if (st->invalid)
+            return 0;
+
+        auto parent = st->primary.get_handle(true);
+        if (!parent)
+            return std::unexpected{parent.error()};
+
+        std::size_t restored = 0;
+        for (auto& [name, item] : st->items) {
+            auto data = detail::read_raw_item(*parent, name, item.type);
+            if (data && *data == item.data)
+                continue;
+            auto status = detail::write_item(*parent, name, item);
+            if (status != WUPS_STORAGE_ERROR_SUCCESS)
+                return std::unexpected{storage_error{"error restoring key \"" + name + "\"",
+                                                     status}};
+            logger::printf("Restored key \"%s\" from mirror\n", name.c_str());
+            ++restored;
+        }
+        return restored;
+    }
+
+
+    std::expected<void, storage_error>
+    mirror::update()
+    {
+        // Note: same order as save() and store(): storage, then this mirror.
+        std::lock_guard storage_guard{detail::storage_mutex()};
+        std::lock_guard guard{st->mut};
+        detail::load(*st);
+
+        if (st->dirty.empty() && !st->rewrite)
+            return {};
+
+        // Note: from here on, any error leaves the mirror behind the saved config.
+        auto parent = st->primary.get_handle(true);
+        if (!parent) {
+            detail::invalidate(*st);
+            return std::unexpected{parent.error()};
+        }
+
+        // Only the dirty keys are read back and hashed again.
+        std::vector<std::string> changed;
+        for (auto& [name, dirty_type] : st->dirty) {
+            auto it = st->items.find(name);
+            auto type = dirty_type;
+            if (type == detail::no_item_type && it != st->items.end())
+                type = it->second.type; // check it was really removed
+            std::expected<std::vector<std::byte>, WUPSStorageError> data
+                = std::unexpected{WUPS_STORAGE_ERROR_NOT_FOUND};
+            if (type != detail::no_item_type)
+                data = detail::read_raw_item(*parent, name, type);
+            if (!data && data.error() != WUPS_STORAGE_ERROR_NOT_FOUND) {
+                detail::invalidate(*st);
+                return std::unexpected{storage_error{"error mirroring key \"" + name + "\"",
+                                                     data.error()}};
+            }
+
+            if (data) {
+                if (it != st->items.end() && it->second.type == type && it->second.data == *data)
+                    continue;
+                detail::put_item(*st, name, type, std::move(*data));
+            } else {
+                if (it == st->items.end())
+                    continue;
+                detail::erase_item(*st, name);
+            }
+            changed.push_back(name);
+        }
+        st->dirty.clear();
+
+        // Append the changes, unless the file would become more than twice as big as
+        // a fresh copy.
+        const std::size_t full_size = sizeof(detail::file_header) + st->items_size;
+        bool ok;
+        if (st->rewrite || st->file_size > 2 * full_size)
+            ok = detail::write_full(*st);
+        else if (!changed.empty())
+            ok = detail::write_block(*st, changed);
+        else
+            ok = true;
+        if (!ok) {
+            detail::invalidate(*st);
+            return std::unexpected{storage_error{"error writing mirror file \""
+                                                 + st->filename.string() + "\"",
+                                                 WUPS_STORAGE_ERROR_IO_ERROR}};
+        }
+        st->invalid = false;
+        return {};
+    }
+
+} // namespace wups::storage
@@ -0,0 +1,310 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // any_of(), erase_if(), find()
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>              // move()
+#include <vector>
+
+#include "wupsxx/storage_observer.hpp"
+
+#include "wupsxx/logger.hpp"
+
+
+namespace wups::storage {
+
+    namespace {
+
+        struct entry {
+            std::uint64_t id;
+            group parent;
+            std::string key;     // empty when observing an address
+            std::uint32_t hash;
+            const void* address; // null when observing a key
+            observer obs;
+        };
+
+
+        // Checked before taking the mutex, so notify() is cheap when nobody observes.
+        std::atomic_uint num_entries = 0;
+
+        std::uint64_t next_id = 1;
+
+        // The observers being called right now, and the threads calling them.
+        // Note: flush_notifications() may still be joining one thread when notify()
+        // starts the next one.
+        struct delivery {
+            std::thread::id thread;
+            std::uint64_t id;
+        };
+
+
+        // Note: function-local statics, because observers are often registered from
+        // global constructors.
+
+        std::mutex&
+        get_mutex()
+        {
+            static std::mutex mutex;
+            return mutex;
+        }
+
+
+        std::condition_variable_any&
+        get_cond()
+        {
+            static std::condition_variable_any cond;
+            return cond;
+        }
+
+
+        std::vector<entry>&
+        get_entries()
+        {
+            static std::vector<entry> entries;
+            return entries;
+        }
+
+
+        std::vector<std::uint64_t>&
+        get_pending()
+        {
+            static std::vector<std::uint64_t> pending;
+            return pending;
+        }
+
+
+        std::vector<delivery>&
+        get_in_flight()
+        {
+            static std::vector<delivery> in_flight;
+            return in_flight;
+        }
+
+
+        // Assumes the mutex is locked.
+        bool
+        is_in_flight(std::uint64_t id)
+        {
+            const auto self = std::this_thread::get_id();
+            // An observer can unsubscribe itself without waiting.
+            return std::ranges::any_of(get_in_flight(), [id, self](const delivery& d)
+            {
+                return d.id == id && d.thread != self;
+            });
+        }
+
+
+        std::jthread&
+        get_worker()
+        {
+            static std::jthread worker;
+            return worker;
+        }
+
+
+        void
+        run(std::stop_token token)
+        {
+            auto& cond = get_cond();
+            std::unique_lock lock{get_mutex()};
+            const auto self = std::this_thread::get_id();
+            auto& pending = get_pending();
+            auto& in_flight = get_in_flight();
+            for (;;) {
+                cond.wait(lock, token, [&pending] { return !pending.empty(); });
+                if (pending.empty())
+                    return; // stop was requested, nothing left to deliver
+
+                auto batch = std::move(pending);
+                pending.clear();
+                for (auto id : batch) {
+                    // Look it up again for every call, since it may be unsubscribed by now.
+                    auto& entries = get_entries();
+                    auto it = std::ranges::find(entries, id, &entry::id);
+                    if (it == entries.end())
+                        continue;
+                    observer obs = it->obs;
+                    in_flight.push_back({self, id});
+                    lock.unlock();
+
+#ifdef __cpp_exceptions
+                    try {
+                        obs();
+                    }
+                    catch (std::exception& e) {
+                        logger::printf("Error in storage observer: %s\n", e.what());
+                    }
+#else
+                    obs();
+#endif
+
+                    lock.lock();
+                    std::erase_if(in_flight,
+                                  [self](const delivery& d) { return d.thread == self; });
+                    cond.notify_all(); // wake up reset()
+                }
+            }
+        }
+
+
+        // Assumes the mutex is locked.
+        void
+        schedule(std::uint64_t id)
+        {
+            auto& pending = get_pending();
+            if (std::ranges::find(pending, id) != pending.end())
+                return; // coalesce with the pending notification
+            pending.push_back(id);
+            auto& worker = get_worker();
+            if (!worker.joinable())
+                worker = std::jthread{run};
+            get_cond().notify_all();
+        }
+
+
+        subscription
+        add(entry&& e)
+        {
+            std::lock_guard guard{get_mutex()};
+            e.id = next_id++;
+            get_entries().push_back(std::move(e));
+            ++num_entries;
+            return subscription{get_entries().back().id};
+        }
+
+    } // namespace
+
+
+    subscription::subscription(std::uint64_t id)
+        noexcept :
+        id{id}
+    {}
+
+
+    subscription::subscription(subscription&& other)
+        noexcept :
+        id{other.id}
+    {
+        other.id = 0;
+    }
+
+
+    subscription::~subscription()
+    {
+        reset();
+    }
+
+
+    subscription&
+    subscription::operator =(subscription&& other)
+        noexcept
+    {
+        if (this != &other) {
+            reset();
+            id = other.id;
+            other.id = 0;
+        }
+        return *this;
+    }
+
+
+    void
+    subscription::reset()
+        noexcept
+    {
+        if (!id)
+            return;
+        std::unique_lock lock{get_mutex()};
+        num_entries -= std::erase_if(get_entries(),
+                                     [this](const entry& e) { return e.id == id; });
+        // Wait for the observer to return, so it doesn't outlive the subscription.
+        get_cond().wait(lock, [this] { return !is_in_flight(id); });
+        id = 0;
+    }
+
+
+    subscription
+    observe(const group& parent, const key& k, observer obs)
+    {
+        return add(entry{
+                .id = 0,
+                .parent = parent,
+                .key = std::string{k.name()},
+                .hash = k.hash(),
+                .address = nullptr,
+                .obs = std::move(obs)
+            });
+    }
+
+
+    subscription
+    observe(const key& k, observer obs)
+    {
+        return observe(group{}, k, std::move(obs));
+    }
+
+
+    subscription
+    observe_address(const void* address, observer obs)
+    {
+        return add(entry{
+                .id = 0,
+                .parent = {},
+                .key = {},
+                .hash = 0,
+                .address = address,
+                .obs = std::move(obs)
+            });
+    }
+
+
+    void
+    notify(const group& parent, const key& k)
+    {
+        if (!num_entries)
+            return;
+        std::lock_guard guard{get_mutex()};
+        for (auto& e : get_entries())
+            if (!e.address && e.hash == k.hash() && e.parent == parent && e.key == k.name())
+                schedule(e.id);
+    }
+
+
+    void
+    notify_address(const void* address)
+    {
+        if (!num_entries)
+            return;
+        std::lock_guard guard{get_mutex()};
+        for (auto& e : get_entries())
+            if (e.address == address)
+                schedule(e.id);
+    }
+
+
+    void
+    flush_notifications()
+    {
+        std::jthread old_worker;
+        {
+            std::lock_guard guard{get_mutex()};
+            old_worker = std::move(get_worker());
+        }
+        // Note: the thread delivers anything pending before it finishes.
+        if (old_worker.joinable()) {
+            old_worker.request_stop();
+            old_worker.join();
+        }
+    }
+
+} // namespace wups::storage
@@ -0,0 +1,198 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // find(), min(), max()
+#include <atomic>
+#include <mutex>
+#include <numeric>              // accumulate()
+
+#include "wupsxx/storage_stats.hpp"
+
+#include "wupsxx/storage_group.hpp"
+
+
+using namespace std::literals;
+
+
+namespace wups::storage::stats {
+
+    namespace {
+
+        std::atomic_bool active = false;
+
+        std::mutex stats_mutex;
+
+        snapshot current;
+
+
+        std::size_t
+        type_slot(WUPSStorageItemType type)
+            noexcept
+        {
+            return type < num_item_types ? type : num_item_types;
+        }
+
+
+        std::size_t
+        error_slot(WUPSStorageError status)
+            noexcept
+        {
+            auto it = std::ranges::find(known_errors, status);
+            return it - known_errors.begin();
+        }
+
+    } // namespace
+
+
+    std::chrono::microseconds
+    timing::mean()
+        const noexcept
+    {
+        if (!count)
+            return 0us;
+        return total / count;
+    }
+
+
+    void
+    timing::add(std::chrono::microseconds d)
+        noexcept
+    {
+        ++count;
+        total += d;
+        min = std::min(min, d);
+        max = std::max(max, d);
+        std::size_t i = 0;
+        while (i + 1 < num_buckets && d >= bucket_limit(i))
+            ++i;
+        ++histogram[i];
+    }
+
+
+    std::uint32_t
+    snapshot::total_loads()
+        const noexcept
+    {
+        return std::accumulate(loads.begin(), loads.end(), std::uint32_t{0});
+    }
+
+
+    std::uint32_t
+    snapshot::total_stores()
+        const noexcept
+    {
+        return std::accumulate(stores.begin(), stores.end(), std::uint32_t{0});
+    }
+
+
+    std::uint32_t
+    snapshot::failures_of(WUPSStorageError status)
+        const noexcept
+    {
+        return failures[error_slot(status)];
+    }
+
+
+    std::uint32_t
+    snapshot::total_failures()
+        const noexcept
+    {
+        return std::accumulate(failures.begin(), failures.end(), std::uint32_t{0});
+    }
+
+
+    void
+    enable(bool on)
+        noexcept
+    {
+        active.store(on, std::memory_order_relaxed);
+    }
+
+
+    bool
+    enabled()
+        noexcept
+    {
+        return active.load(std::memory_order_relaxed);
+    }
+
+
+    snapshot
+    get()
+    {
+        std::lock_guard guard{stats_mutex};
+        return current;
+    }
+
+
+    void
+    reset()
+        noexcept
+    {
+        std::lock_guard guard{stats_mutex};
+        current = {};
+    }
+
+} // namespace wups::storage::stats
+
+
+namespace wups::storage::detail {
+
+    void
+    count_load(WUPSStorageItemType type)
+        noexcept
+    {
+        if (!stats::enabled())
+            return;
+        std::lock_guard guard{stats::stats_mutex};
+        ++stats::current.loads[stats::type_slot(type)];
+    }
+
+
+    void
+    count_store(WUPSStorageItemType type,
+                std::size_t bytes)
+        noexcept
+    {
+        if (!stats::enabled())
+            return;
+        std::lock_guard guard{stats::stats_mutex};
+        ++stats::current.stores[stats::type_slot(type)];
+        stats::current.bytes_written += bytes;
+    }
+
+
+    void
+    count_failure(WUPSStorageError status)
+        noexcept
+    {
+        if (!stats::enabled())
+            return;
+        std::lock_guard guard{stats::stats_mutex};
+        ++stats::current.failures[stats::error_slot(status)];
+    }
+
+
+    void
+    count_save(std::chrono::microseconds d)
+        noexcept
+    {
+        std::lock_guard guard{stats::stats_mutex};
+        stats::current.save.add(d);
+    }
+
+
+    void
+    count_reload(std::chrono::microseconds d)
+        noexcept
+    {
+        std::lock_guard guard{stats::stats_mutex};
+        stats::current.reload.add(d);
+    }
+
+} // namespace wups::storage::detail
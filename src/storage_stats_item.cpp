@@ -0,0 +1,261 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // min()
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>               // vsnprintf()
+
+#include "wupsxx/storage_stats_item.hpp"
+
+#include "wupsxx/cafe_glyphs.h"
+#include "wupsxx/storage_stats.hpp"
+
+
+namespace stats = wups::storage::stats;
+
+
+namespace {
+
+    enum page_id : unsigned {
+        totals,
+        loads,
+        stores,
+        save_times,
+        save_histogram,
+        reload_times,
+        reload_histogram,
+        failures,
+        num_pages
+    };
+
+
+    const char* type_names[stats::num_item_types + 1] = {
+        "s32", "s64", "u32", "u64", "str", "bin", "bool", "float", "double", "other"
+    };
+
+
+    // Appends to a C string, truncating when it's full.
+    class line_writer {
+
+        char* buf;
+        std::size_t size;
+        std::size_t used = 0;
+
+    public:
+
+        line_writer(char* buf, std::size_t size) :
+            buf{buf},
+            size{size}
+        {
+            if (size)
+                buf[0] = '\0';
+        }
+
+
+        [[gnu::format(printf, 2, 3)]]
+        void
+        printf(const char* fmt, ...)
+        {
+            if (used + 1 >= size)
+                return;
+            std::va_list args;
+            va_start(args, fmt);
+            int n = std::vsnprintf(buf + used, size - used, fmt, args);
+            va_end(args);
+            if (n > 0)
+                used = std::min(used + n, size - 1);
+        }
+
+    };
+
+
+    unsigned
+    ms(std::chrono::microseconds d)
+    {
+        return d.count() / 1000;
+    }
+
+
+    void
+    write_counts(line_writer& out,
+                 const char* title,
+                 const decltype(stats::snapshot::loads)& counts)
+    {
+        out.printf("%s:", title);
+        bool any = false;
+        for (std::size_t i = 0; i < counts.size(); ++i)
+            if (counts[i]) {
+                out.printf(" %s %u", type_names[i], unsigned(counts[i]));
+                any = true;
+            }
+        if (!any)
+            out.printf(" none");
+    }
+
+
+    void
+    write_times(line_writer& out,
+                const char* title,
+                const stats::timing& t)
+    {
+        if (!t.count) {
+            out.printf("%s: none", title);
+            return;
+        }
+        out.printf("%s: %u, avg %u ms, min %u ms, max %u ms",
+                   title,
+                   unsigned(t.count),
+                   ms(t.mean()),
+                   ms(t.min),
+                   ms(t.max));
+    }
+
+
+    void
+    write_histogram(line_writer& out,
+                    const char* title,
+                    const stats::timing& t)
+    {
+        out.printf("%s ms:", title);
+        if (!t.count) {
+            out.printf(" none");
+            return;
+        }
+        for (std::size_t i = 0; i < t.num_buckets; ++i) {
+            if (!t.histogram[i])
+                continue;
+            if (i + 1 < t.num_buckets)
+                out.printf(" <%u:%u",
+                           unsigned(t.bucket_limit(i).count()),
+                           unsigned(t.histogram[i]));
+            else
+                out.printf(" %u+:%u",
+                           unsigned(t.bucket_limit(i - 1).count()),
+                           unsigned(t.histogram[i]));
+        }
+    }
+
+
+    void
+    write_page(line_writer& out,
+               unsigned page)
+    {
+        if (!stats::enabled()) {
+            out.printf("disabled");
+            return;
+        }
+
+        auto s = stats::get();
+
+        switch (page) {
+
+        case totals:
+            out.printf("%u loads, %u stores, %.1f KiB written, %u failures",
+                       unsigned(s.total_loads()),
+                       unsigned(s.total_stores()),
+                       s.bytes_written / 1024.0,
+                       unsigned(s.total_failures()));
+            break;
+
+        case loads:
+            write_counts(out, "loads", s.loads);
+            break;
+
+        case stores:
+            write_counts(out, "stores", s.stores);
+            break;
+
+        case save_times:
+            write_times(out, "saves", s.save);
+            break;
+
+        case save_histogram:
+            write_histogram(out, "save", s.save);
+            break;
+
+        case reload_times:
+            write_times(out, "reloads", s.reload);
+            break;
+
+        case reload_histogram:
+            write_histogram(out, "reload", s.reload);
+            break;
+
+        case failures:
+            out.printf("failures:");
+            if (!s.total_failures()) {
+                out.printf(" none");
+                break;
+            }
+            for (auto code : stats::known_errors)
+                if (auto n = s.failures_of(code))
+                    out.printf(" %s %u", WUPSStorageAPI_GetStatusStr(code), unsigned(n));
+            if (auto n = s.failures.back())
+                out.printf(" other %u", unsigned(n));
+            break;
+
+        }
+    }
+
+} // namespace
+
+
+namespace wups::config {
+
+    storage_stats_item::storage_stats_item(const std::string& label) :
+        item{label}
+    {
+        // The counters change on their own.
+        set_display_cache(false);
+    }
+
+
+    std::unique_ptr<storage_stats_item>
+    storage_stats_item::create(const std::string& label)
+    {
+        return std::make_unique<storage_stats_item>(label);
+    }
+
+
+    void
+    storage_stats_item::get_display(char* buf, std::size_t size)
+        const
+    {
+        line_writer out{buf, size};
+        write_page(out, page);
+    }
+
+
+    void
+    storage_stats_item::get_focused_display(char* buf, std::size_t size)
+        const
+    {
+        line_writer out{buf, size};
+        out.printf("%s ", CAFE_GLYPH_BTN_LEFT);
+        write_page(out, page);
+        out.printf(" %s", CAFE_GLYPH_BTN_RIGHT);
+    }
+
+
+    focus_status
+    storage_stats_item::on_input(const simple_pad_data& input)
+    {
+        if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_LEFT))
+            page = (page + num_pages - 1) % num_pages;
+
+        if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_RIGHT))
+            page = (page + 1) % num_pages;
+
+        if (input.buttons_d & (WUPS_CONFIG_BUTTON_A | WUPS_CONFIG_BUTTON_B))
+            return focus_status::lose;
+
+        return focus_status::keep;
+    }
+
+} // namespace wups::config
@@ -0,0 +1,132 @@
+/*
+ * libwupsxx - A C++ wrapper for libwups.
+ *
+ * Copyright (C) 2024  Daniel K. O.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <algorithm>            // find_if(), any_of()
+#include <mutex>
+#include <ranges>
+
+#include "wupsxx/storage_transaction.hpp"
+
+
+namespace wups::storage {
+
+    namespace detail {
+
+        staged_store::staged_store(const group& parent,
+                                   const key& k) :
+            parent{parent},
+            name{k.name()}
+        {}
+
+
+        staged_store::~staged_store() = default;
+
+
+        variable_backup::variable_backup(const void* address)
+            noexcept :
+            address{address}
+        {}
+
+
+        variable_backup::~variable_backup() = default;
+
+    } // namespace detail
+
+
+    transaction::~transaction()
+    {
+        rollback();
+    }
+
+
+    std::expected<void, storage_error>
+    transaction::try_commit()
+    {
+        // Nobody else sees the keys while they're half written.
+        std::lock_guard guard{detail::storage_mutex()};
+#ifdef __cpp_exceptions
+        try {
+#endif
+            for (auto& entry : stores) {
+                auto res = entry->commit();
+                if (!res) {
+                    rollback();
+                    return res;
+                }
+            }
+#ifdef __cpp_exceptions
+        }
+        catch (...) {
+            rollback();
+            throw;
+        }
+#endif
+        stores.clear();
+        backups.clear();
+        return {};
+    }
+
+
+    void
+    transaction::commit()
+    {
+        auto res = try_commit();
+        if (!res)
+            detail::raise(res.error());
+    }
+
+
+    void
+    transaction::rollback()
+        noexcept
+    {
+        // Entries that were not written ignore undo().
+        for (auto& entry : stores | std::views::reverse) {
+#ifdef __cpp_exceptions
+            try {
+                entry->undo();
+            }
+            catch (...) {
+                // Best-effort: keep undoing the other entries.
+            }
+#else
+            entry->undo();
+#endif
+        }
+        stores.clear();
+        for (auto& entry : backups | std::views::reverse)
+            entry->restore();
+        backups.clear();
+    }
+
+
+    void
+    transaction::stage(std::unique_ptr<detail::staged_store> entry)
+    {
+        auto it = std::ranges::find_if(stores, [&entry](const auto& e)
+        {
+            return e->parent == entry->parent && e->name == entry->name;
+        });
+        if (it != stores.end())
+            *it = std::move(entry);
+        else
+            stores.push_back(std::move(entry));
+    }
+
+
+    bool
+    transaction::is_backed_up(const void* address)
+        const noexcept
+    {
+        return std::ranges::any_of(backups, [address](const auto& b)
+        {
+            return b->address == address;
+        });
+    }
+
+} // namespace wups::storage
@@ -6,23 +6,29 @@
  * SPDX-License-Identifier: MIT
  */
 
-#include <algorithm>            // clamp(), min()
-#include <cstdio>               // snprintf()
+#include <algorithm>            // lower_bound(), min(), upper_bound()
+#include <cstring>              // memcpy()
 
 #include "wupsxx/text_item.hpp"
 
 #include "wupsxx/cafe_glyphs.h"
 
+#include "utils.hpp"
 
-namespace {
 
-    const std::string left_glyph = CAFE_GLYPH_BTN_LEFT " ";
-    const std::string right_glyph = " " CAFE_GLYPH_BTN_RIGHT;
+namespace wups::config {
 
-}
+    namespace {
 
+        const text_item::marker no_marker = {"", 0};
+
+        const text_item::marker ellipsis = {"…", 1};
+
+        const text_item::marker left_glyph = {CAFE_GLYPH_BTN_LEFT " ", 2};
+        const text_item::marker right_glyph = {" " CAFE_GLYPH_BTN_RIGHT, 2};
+
+    } // namespace
 
-namespace wups::config {
 
     text_item::text_item(const std::string& label,
                          const std::string& text,
@@ -30,7 +36,9 @@ namespace wups::config {
         item{label},
         text{text},
         max_width{std::min<std::size_t>(max_width, 79)}
-    {}
+    {
+        update_index();
+    }
 
 
     std::unique_ptr<text_item>
@@ -42,47 +50,64 @@ namespace wups::config {
     }
 
 
+    const std::string&
+    text_item::get_text()
+        const noexcept
+    {
+        return text;
+    }
+
+
     void
-    text_item::get_display(char* buf,
-                           std::size_t size)
-        const
+    text_item::set_text(const std::string& new_text)
     {
-        // TODO: process this in std::u32string?
+        text = new_text;
+        update_index();
+        set_first(first);
+        if (marquee)
+            start_marquee(marquee->options);
+        invalidate_display();
+    }
 
-        // Note: `buf` is a C string, it needs a null terminator at the end,
-        // so the effective `width` is one less than `size`.
-        std::size_t width = std::min(size - 1, max_width);
 
-        if (width >= text.size()) {
-            // Easy case: text fits, just show it all.
-            std::snprintf(buf, size, "%s", text.c_str());
-            return;
-        }
+    void
+    text_item::start_marquee()
+    {
+        start_marquee(marquee_options{});
+    }
 
-        const char* ellipsis = "…";
 
-        std::string prefix;
-        if (first > 0)
-            prefix = ellipsis;
-        if (width < prefix.size()) // sanity check
-            return;
-        width -= prefix.size();
+    void
+    text_item::start_marquee(const marquee_options& options)
+    {
+        marquee.emplace(marquee_state{
+                .options = options,
+                .start = options.now(),
+                .last = last_first(ellipsis),
+            });
+        invalidate_display();
+    }
 
-        std::size_t last = first + width;
-        std::string suffix;
-        if (last < text.size())
-            suffix = ellipsis;
-        if (width < suffix.size()) // sanity check
-            return;
-        width -= suffix.size();
 
-        std::string slice = text.substr(first, width);
+    void
+    text_item::stop_marquee()
+        noexcept
+    {
+        marquee.reset();
+        invalidate_display();
+    }
 
-        std::snprintf(buf, size,
-                      "%s%s%s",
-                      prefix.c_str(),
-                      slice.c_str(),
-                      suffix.c_str());
+
+    void
+    text_item::get_display(char* buf,
+                           std::size_t size)
+        const
+    {
+        if (marquee) {
+            marquee->shown = marquee_column();
+            render(buf, size, marquee->shown, ellipsis, ellipsis);
+        } else
+            render(buf, size, first, ellipsis, ellipsis);
     }
 
 
@@ -91,40 +116,7 @@ namespace wups::config {
                                    std::size_t size)
         const
     {
-        // TODO: process this in std::u32string
-
-        // Note: `buf` is a C string, it needs a null terminator at the end,
-        // so the effective `width` is one less than `size`.
-        std::size_t width = std::min(size - 1, max_width);
-
-        if (width >= text.size()) {
-            // Easy case: text fits, just show it all.
-            std::snprintf(buf, size, "%s", text.c_str());
-            return;
-        }
-
-        std::string prefix;
-        if (first > 0)
-            prefix = left_glyph;
-        if (width < prefix.size()) // sanity check
-            return;
-        width -= prefix.size();
-
-        std::size_t last = first + width;
-        std::string suffix;
-        if (last < text.size())
-            suffix = right_glyph;
-        if (width < suffix.size()) // sanity check
-            return;
-        width -= suffix.size();
-
-        std::string slice = text.substr(first, width);
-
-        std::snprintf(buf, size,
-                      "%s%s%s",
-                      prefix.c_str(),
-                      slice.c_str(),
-                      suffix.c_str());
+        render(buf, size, first, left_glyph, right_glyph);
     }
 
 
@@ -133,7 +125,7 @@ namespace wups::config {
         const
     {
         // Don't let small text be focused, there's no scrolling.
-        if (new_focus && text.size() <= max_width)
+        if (new_focus && get_width() <= max_width)
             return false;
         return true;
     }
@@ -143,19 +135,20 @@ namespace wups::config {
     text_item::on_input(const simple_pad_data& input)
     {
         // Only process inputs if text is not fully visible.
-        if (text.size() > max_width) {
+        if (get_width() > max_width) {
 
             // Handle text scrolling
 
-            const std::size_t max_first = text.size() - max_width + left_glyph.size();
+            const std::size_t max_first = last_first(left_glyph);
+            const std::size_t idx = char_at(first);
 
             if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_LEFT))
-                if (first > 0)
-                    --first;
+                if (idx > 0)
+                    first = columns[idx - 1];
 
             if (input.pressed_or_repeated(WUPS_CONFIG_BUTTON_RIGHT))
                 if (first < max_first)
-                    ++first;
+                    first = columns[idx + 1];
 
             if (input.buttons_d & WUPS_CONFIG_BUTTON_L)
                 first = 0;
@@ -172,4 +165,184 @@ namespace wups::config {
             return focus_status::lose; // should not be reachable
     }
 
+
+    bool
+    text_item::is_display_outdated()
+        const noexcept
+    {
+        if (!marquee || has_focus())
+            return false;
+        return marquee_column() != marquee->shown;
+    }
+
+
+    std::size_t
+    text_item::get_width()
+        const noexcept
+    {
+        return columns.back();
+    }
+
+
+    std::size_t
+    text_item::get_max_width()
+        const noexcept
+    {
+        return max_width;
+    }
+
+
+    std::size_t
+    text_item::get_first()
+        const noexcept
+    {
+        return first;
+    }
+
+
+    void
+    text_item::set_first(std::size_t column)
+        noexcept
+    {
+        first = columns[char_at(column)];
+    }
+
+
+    std::size_t
+    text_item::last_first(const marker& left)
+        const noexcept
+    {
+        const std::size_t width = get_width();
+        if (width <= max_width)
+            return 0;
+        // The tail must fit after the left marker.
+        std::size_t needed = width + left.width - max_width;
+        auto it = std::ranges::lower_bound(columns, needed);
+        if (it == columns.end())
+            return width;
+        return *it;
+    }
+
+
+    void
+    text_item::render(char* buf,
+                      std::size_t size,
+                      std::size_t start,
+                      const marker& left,
+                      const marker& right)
+        const noexcept
+    {
+        // Note: `buf` is a C string, it needs a null terminator at the end.
+        if (size == 0)
+            return;
+        std::size_t bytes_left = size - 1;
+        std::size_t cols_left = std::min(size - 1, max_width);
+
+        const std::size_t count = offsets.size() - 1;
+        const std::size_t begin = char_at(start);
+
+        const marker& prefix = begin > 0 ? left : no_marker;
+        if (cols_left < prefix.width || bytes_left < prefix.str.size()) { // sanity check
+            buf[0] = '\0';
+            return;
+        }
+        cols_left -= prefix.width;
+        bytes_left -= prefix.str.size();
+
+        auto fits = [&](std::size_t end)
+        {
+            return columns[end] - columns[begin] <= cols_left
+                && offsets[end] - offsets[begin] <= bytes_left;
+        };
+
+        std::size_t end = begin;
+        while (end < count && fits(end + 1))
+            ++end;
+
+        const marker& suffix = end < count ? right : no_marker;
+        if (end < count) {
+            if (cols_left < suffix.width || bytes_left < suffix.str.size()) { // sanity check
+                buf[0] = '\0';
+                return;
+            }
+            cols_left -= suffix.width;
+            bytes_left -= suffix.str.size();
+            while (end > begin && !fits(end))
+                --end;
+        }
+
+        char* out = buf;
+        std::memcpy(out, prefix.str.data(), prefix.str.size());
+        out += prefix.str.size();
+        std::memcpy(out, text.data() + offsets[begin], offsets[end] - offsets[begin]);
+        out += offsets[end] - offsets[begin];
+        std::memcpy(out, suffix.str.data(), suffix.str.size());
+        out += suffix.str.size();
+        *out = '\0';
+    }
+
+
+    void
+    text_item::update_index()
+    {
+        offsets.clear();
+        columns.clear();
+
+        std::size_t col = 0;
+        std::size_t pos = 0;
+        bool leading = false; // only zero-width code points so far
+        while (pos < text.size()) {
+            const std::size_t start = pos;
+            const unsigned width = utils::display_width(utils::decode_utf8(text, pos));
+            if (leading) {
+                // Leading zero-width code points go with the first character after them.
+                leading = width == 0;
+                col += width;
+                continue;
+            }
+            // Zero-width code points stay with the character before them.
+            if (width == 0 && !offsets.empty())
+                continue;
+            offsets.push_back(start);
+            columns.push_back(col);
+            col += width;
+            leading = width == 0;
+        }
+        offsets.push_back(text.size());
+        columns.push_back(col);
+    }
+
+
+    std::size_t
+    text_item::marquee_column()
+        const noexcept
+    {
+        const auto& opt = marquee->options;
+        if (marquee->last == 0 || opt.step.count() <= 0)
+            return 0;
+
+        const auto scroll = opt.step * marquee->last;
+        const auto cycle = opt.pause + scroll + opt.pause;
+        auto t = (opt.now() - marquee->start) % cycle;
+        if (t < opt.pause)
+            return 0;
+        t -= opt.pause;
+        if (t < scroll)
+            return t / opt.step;
+        return marquee->last;
+    }
+
+
+    std::size_t
+    text_item::char_at(std::size_t column)
+        const noexcept
+    {
+        // The last character that starts at or before `column`.
+        auto it = std::ranges::upper_bound(columns, column);
+        if (it != columns.begin())
+            --it;
+        // Note: text with only zero-width code points ends on the column it starts.
+        return std::ranges::lower_bound(columns, *it) - columns.begin();
+    }
+
 } // namespace wups::config
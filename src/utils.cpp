@@ -62,4 +62,90 @@ namespace wups::utils {
         return result;
     }
 
+
+    char32_t
+    decode_utf8(std::string_view str,
+                std::size_t& pos)
+        noexcept
+    {
+        const char32_t invalid = U'\uFFFD';
+
+        unsigned char lead = str[pos++];
+        if (lead < 0x80)
+            return lead;
+
+        unsigned extra;
+        char32_t c;
+        if ((lead & 0xe0) == 0xc0) {
+            extra = 1;
+            c = lead & 0x1f;
+        } else if ((lead & 0xf0) == 0xe0) {
+            extra = 2;
+            c = lead & 0x0f;
+        } else if ((lead & 0xf8) == 0xf0) {
+            extra = 3;
+            c = lead & 0x07;
+        } else
+            return invalid;
+
+        if (str.size() - pos < extra)
+            return invalid;
+        for (unsigned i = 0; i < extra; ++i) {
+            unsigned char next = str[pos + i];
+            if ((next & 0xc0) != 0x80)
+                return invalid;
+            c = (c << 6) | (next & 0x3f);
+        }
+        pos += extra;
+        return c;
+    }
+
+
+    unsigned
+    display_width(char32_t c)
+        noexcept
+    {
+        struct range {
+            char32_t first;
+            char32_t last;
+        };
+
+        static constexpr range zero_width[] = {
+            {0x0300, 0x036f}, // combining diacritical marks
+            {0x1ab0, 0x1aff},
+            {0x1dc0, 0x1dff},
+            {0x200b, 0x200f}, // zero width space, joiners, direction marks
+            {0x20d0, 0x20ff},
+            {0xfe00, 0xfe0f}, // variation selectors
+            {0xfe20, 0xfe2f},
+        };
+
+        static constexpr range wide[] = {
+            {0x1100, 0x115f}, // Hangul Jamo
+            {0x2e80, 0x303e}, // CJK radicals, punctuation
+            {0x3041, 0x33ff}, // kana, CJK compatibility
+            {0x3400, 0x4dbf}, // CJK extension A
+            {0x4e00, 0x9fff}, // CJK unified ideographs
+            {0xa000, 0xa4cf}, // Yi
+            {0xac00, 0xd7a3}, // Hangul syllables
+            {0xf900, 0xfaff}, // CJK compatibility ideographs
+            {0xfe30, 0xfe4f}, // CJK compatibility forms
+            {0xff00, 0xff60}, // fullwidth forms
+            {0xffe0, 0xffe6},
+            {0x1f300, 0x1f64f}, // emoji
+            {0x1f900, 0x1f9ff},
+            {0x20000, 0x3fffd}, // CJK extensions
+        };
+
+        if (c < 0x300)
+            return 1;
+        for (auto [first, last] : zero_width)
+            if (first <= c && c <= last)
+                return 0;
+        for (auto [first, last] : wide)
+            if (first <= c && c <= last)
+                return 2;
+        return 1;
+    }
+
 } // namespace wups::utils
@@ -9,14 +9,33 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
+#include <cstddef>
+#include <cstdlib>              // abort()
 #include <string>
 #include <string_view>
 #include <variant>
 #include <vector>
 
+#include "wupsxx/logger.hpp"
+
 
 namespace wups::utils {
 
+    // Throw `E`; when built without exceptions, log the message and abort.
+    template<typename E>
+    [[noreturn]]
+    void
+    raise(const std::string& msg)
+    {
+#ifdef __cpp_exceptions
+        throw E{msg};
+#else
+        logger::printf("Fatal error: %s\n", msg.c_str());
+        std::abort();
+#endif
+    }
+
+
     std::string
     concat(const std::string& a,
            const std::string& b,
@@ -28,6 +47,21 @@ namespace wups::utils {
                const std::string& sep = "+ ");
 
 
+    // Decode the code point at `pos`, and advance `pos` past it; invalid bytes are
+    // decoded as U+FFFD, one byte at a time.
+    char32_t
+    decode_utf8(std::string_view str,
+                std::size_t& pos)
+        noexcept;
+
+
+    // How many columns a code point takes: 0 for combining marks and joiners, 2 for
+    // East Asian wide characters, 1 for everything else (including the Cafe glyphs.)
+    unsigned
+    display_width(char32_t c)
+        noexcept;
+
+
     // return a reference to a variant entry, initialized if necessary
     template<typename T,
              typename... Ts>